@@ -0,0 +1,359 @@
+#include "allocator.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <clean-core/assert.hh>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+// statistics that are updated under a lock
+struct locked_stats
+{
+    tp::allocator_stats stats;
+
+    void on_allocate(size_t bytes, bool is_reuse)
+    {
+        stats.bytes_live += int64_t(bytes);
+        stats.bytes_peak = stats.bytes_live > stats.bytes_peak ? stats.bytes_live : stats.bytes_peak;
+        stats.allocations++;
+        if (is_reuse)
+            stats.reuses++;
+    }
+    void on_deallocate(size_t bytes) { stats.bytes_live -= int64_t(bytes); }
+};
+
+size_t align_up(size_t v, size_t alignment) { return (v + alignment - 1) & ~(alignment - 1); }
+
+bool is_pow2(size_t v) { return v != 0 && (v & (v - 1)) == 0; }
+
+// chunks and pool buffers are at least cache-line aligned
+constexpr size_t min_block_alignment = 64;
+}
+
+//
+// heap
+//
+struct tp::heap_allocator::impl
+{
+    std::atomic<int64_t> bytes_live = 0;
+    std::atomic<int64_t> bytes_peak = 0;
+    std::atomic<int64_t> allocations = 0;
+};
+
+tp::heap_allocator::heap_allocator() : _impl(new impl()) {}
+tp::heap_allocator::~heap_allocator() { delete _impl; }
+
+std::byte* tp::heap_allocator::allocate(size_t bytes, size_t alignment)
+{
+    CC_ASSERT(is_pow2(alignment) && "alignment must be a power of two");
+    auto const live = _impl->bytes_live.fetch_add(int64_t(bytes), std::memory_order_relaxed) + int64_t(bytes);
+    auto peak = _impl->bytes_peak.load(std::memory_order_relaxed);
+    while (live > peak && !_impl->bytes_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    _impl->allocations.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<std::byte*>(::operator new(bytes, std::align_val_t(alignment)));
+}
+
+void tp::heap_allocator::deallocate(std::byte* p, size_t bytes, size_t alignment)
+{
+    _impl->bytes_live.fetch_sub(int64_t(bytes), std::memory_order_relaxed);
+    ::operator delete(p, std::align_val_t(alignment));
+}
+
+tp::allocator_stats tp::heap_allocator::stats() const
+{
+    allocator_stats s;
+    s.bytes_live = _impl->bytes_live.load(std::memory_order_relaxed);
+    s.bytes_peak = _impl->bytes_peak.load(std::memory_order_relaxed);
+    s.allocations = _impl->allocations.load(std::memory_order_relaxed);
+    return s;
+}
+
+tp::allocator& tp::allocator::heap()
+{
+    static heap_allocator a;
+    return a;
+}
+
+//
+// huge pages
+//
+struct tp::huge_page_allocator::impl
+{
+    mutable std::mutex mutex;
+    size_t threshold = 0;
+    locked_stats stats;
+
+    // large allocations are whole huge pages, so that no huge page is shared with other memory
+    size_t alignment_for(size_t bytes, size_t alignment) const
+    {
+        auto const page = bytes >= threshold ? huge_page_size : page_size;
+        return alignment > page ? alignment : page;
+    }
+};
+
+tp::huge_page_allocator::huge_page_allocator(size_t threshold) : _impl(new impl())
+{
+    _impl->threshold = threshold;
+}
+
+tp::huge_page_allocator::~huge_page_allocator() { delete _impl; }
+
+std::byte* tp::huge_page_allocator::allocate(size_t bytes, size_t alignment)
+{
+    CC_ASSERT(is_pow2(alignment) && "alignment must be a power of two");
+    auto const a = _impl->alignment_for(bytes, alignment);
+    auto const size = align_up(bytes, a);
+    auto const p = static_cast<std::byte*>(::operator new(size, std::align_val_t(a)));
+
+#ifdef __linux__
+    // only a hint: fails harmlessly if THP is disabled
+    if (a >= huge_page_size)
+        ::madvise(p, size, MADV_HUGEPAGE);
+#endif
+
+    std::lock_guard lock(_impl->mutex);
+    _impl->stats.on_allocate(bytes, false);
+    return p;
+}
+
+void tp::huge_page_allocator::deallocate(std::byte* p, size_t bytes, size_t alignment)
+{
+    {
+        std::lock_guard lock(_impl->mutex);
+        _impl->stats.on_deallocate(bytes);
+    }
+    ::operator delete(p, std::align_val_t(_impl->alignment_for(bytes, alignment)));
+}
+
+tp::allocator_stats tp::huge_page_allocator::stats() const
+{
+    std::lock_guard lock(_impl->mutex);
+    return _impl->stats.stats;
+}
+
+//
+// arena
+//
+struct tp::arena_allocator::impl
+{
+    struct chunk
+    {
+        std::byte* data = nullptr;
+        size_t size = 0;
+        size_t high_water = 0; // largest offset ever used, memory below it is reused
+    };
+
+    mutable std::mutex mutex;
+    std::vector<chunk> chunks;
+    size_t current = 0; // chunk that is currently bumped
+    size_t offset = 0;  // bump position inside the current chunk
+    size_t chunk_size = 0;
+    locked_stats stats;
+};
+
+tp::arena_allocator::arena_allocator(size_t chunk_size) : _impl(new impl())
+{
+    CC_ASSERT(chunk_size > 0);
+    _impl->chunk_size = chunk_size;
+}
+
+tp::arena_allocator::~arena_allocator()
+{
+    for (auto const& c : _impl->chunks)
+        ::operator delete(c.data, std::align_val_t(min_block_alignment));
+    delete _impl;
+}
+
+std::byte* tp::arena_allocator::allocate(size_t bytes, size_t alignment)
+{
+    CC_ASSERT(is_pow2(alignment) && "alignment must be a power of two");
+    std::lock_guard lock(_impl->mutex);
+    auto& chunks = _impl->chunks;
+
+    // bump inside the current chunk, otherwise continue in the next (retained) chunk that is large enough
+    for (auto i = _impl->current; i < chunks.size(); ++i)
+    {
+        auto& c = chunks[i];
+        auto const base = reinterpret_cast<uintptr_t>(c.data);
+        auto const start = align_up(base + (i == _impl->current ? _impl->offset : 0), alignment) - base;
+        if (start + bytes > c.size)
+            continue;
+
+        _impl->current = i;
+        _impl->offset = start + bytes;
+        _impl->stats.on_allocate(bytes, _impl->offset <= c.high_water);
+        c.high_water = _impl->offset > c.high_water ? _impl->offset : c.high_water;
+        return c.data + start;
+    }
+
+    // new chunk (large allocations get their own)
+    auto const padding = alignment > min_block_alignment ? alignment : 0;
+    auto const size = bytes + padding > _impl->chunk_size ? bytes + padding : _impl->chunk_size;
+    impl::chunk c;
+    c.data = static_cast<std::byte*>(::operator new(size, std::align_val_t(min_block_alignment)));
+    c.size = size;
+    auto const base = reinterpret_cast<uintptr_t>(c.data);
+    auto const start = align_up(base, alignment) - base;
+    c.high_water = start + bytes;
+    chunks.push_back(c);
+
+    _impl->current = chunks.size() - 1;
+    _impl->offset = start + bytes;
+    _impl->stats.on_allocate(bytes, false);
+    return c.data + start;
+}
+
+void tp::arena_allocator::deallocate(std::byte*, size_t bytes, size_t)
+{
+    // memory is released by reset or rewind
+    std::lock_guard lock(_impl->mutex);
+    _impl->stats.on_deallocate(bytes);
+}
+
+tp::allocator_stats tp::arena_allocator::stats() const
+{
+    std::lock_guard lock(_impl->mutex);
+    return _impl->stats.stats;
+}
+
+void tp::arena_allocator::reset() { rewind({}); }
+
+tp::arena_allocator::marker tp::arena_allocator::mark() const
+{
+    std::lock_guard lock(_impl->mutex);
+    return {_impl->current, _impl->offset};
+}
+
+void tp::arena_allocator::rewind(marker m)
+{
+    std::lock_guard lock(_impl->mutex);
+    CC_ASSERT((m.chunk < _impl->current || (m.chunk == _impl->current && m.offset <= _impl->offset)) && "can only rewind to an earlier position");
+    _impl->current = m.chunk;
+    _impl->offset = m.offset;
+}
+
+void tp::arena_allocator::release_memory()
+{
+    std::lock_guard lock(_impl->mutex);
+    CC_ASSERT(_impl->stats.stats.bytes_live == 0 && "cannot release the memory of an arena with live allocations");
+    for (auto const& c : _impl->chunks)
+        ::operator delete(c.data, std::align_val_t(min_block_alignment));
+    _impl->chunks.clear();
+    _impl->current = 0;
+    _impl->offset = 0;
+}
+
+//
+// pool
+//
+struct tp::pool_allocator::impl
+{
+    mutable std::mutex mutex;
+    std::vector<std::vector<std::byte*>> free_lists; // per size class
+    size_t min_class_size = 0;
+    int64_t bytes_cached = 0;
+    locked_stats stats;
+
+    // class k holds buffers of min_class_size << k bytes
+    size_t class_of(size_t bytes) const
+    {
+        size_t k = 0;
+        while ((min_class_size << k) < bytes)
+            ++k;
+        return k;
+    }
+    size_t alignment_of(size_t class_size) const { return class_size < min_block_alignment ? min_block_alignment : class_size < 4096 ? class_size : 4096; }
+};
+
+tp::pool_allocator::pool_allocator(size_t min_class_size) : _impl(new impl())
+{
+    CC_ASSERT(is_pow2(min_class_size) && "size classes must be powers of two");
+    _impl->min_class_size = min_class_size;
+}
+
+tp::pool_allocator::~pool_allocator()
+{
+    trim();
+    delete _impl;
+}
+
+std::byte* tp::pool_allocator::allocate(size_t bytes, size_t alignment)
+{
+    CC_ASSERT(is_pow2(alignment) && "alignment must be a power of two");
+    std::lock_guard lock(_impl->mutex);
+
+    auto const k = _impl->class_of(bytes);
+    auto const class_size = _impl->min_class_size << k;
+
+    // alignments beyond the class alignment are not pooled
+    if (alignment > _impl->alignment_of(class_size))
+    {
+        _impl->stats.on_allocate(bytes, false);
+        return static_cast<std::byte*>(::operator new(bytes, std::align_val_t(alignment)));
+    }
+
+    if (k < _impl->free_lists.size() && !_impl->free_lists[k].empty())
+    {
+        auto const p = _impl->free_lists[k].back();
+        _impl->free_lists[k].pop_back();
+        _impl->bytes_cached -= int64_t(class_size);
+        _impl->stats.on_allocate(bytes, true);
+        return p;
+    }
+
+    _impl->stats.on_allocate(bytes, false);
+    return static_cast<std::byte*>(::operator new(class_size, std::align_val_t(_impl->alignment_of(class_size))));
+}
+
+void tp::pool_allocator::deallocate(std::byte* p, size_t bytes, size_t alignment)
+{
+    std::lock_guard lock(_impl->mutex);
+    auto const k = _impl->class_of(bytes);
+    if (alignment > _impl->alignment_of(_impl->min_class_size << k))
+    {
+        _impl->stats.on_deallocate(bytes);
+        ::operator delete(p, std::align_val_t(alignment));
+        return;
+    }
+
+    if (k >= _impl->free_lists.size())
+        _impl->free_lists.resize(k + 1);
+    _impl->free_lists[k].push_back(p);
+    _impl->bytes_cached += int64_t(_impl->min_class_size << k);
+    _impl->stats.on_deallocate(bytes);
+}
+
+tp::allocator_stats tp::pool_allocator::stats() const
+{
+    std::lock_guard lock(_impl->mutex);
+    return _impl->stats.stats;
+}
+
+int64_t tp::pool_allocator::bytes_cached() const
+{
+    std::lock_guard lock(_impl->mutex);
+    return _impl->bytes_cached;
+}
+
+void tp::pool_allocator::trim()
+{
+    std::lock_guard lock(_impl->mutex);
+    for (size_t k = 0; k < _impl->free_lists.size(); ++k)
+    {
+        auto const class_size = _impl->min_class_size << k;
+        for (auto p : _impl->free_lists[k])
+            ::operator delete(p, std::align_val_t(_impl->alignment_of(class_size)));
+        _impl->free_lists[k].clear();
+    }
+    _impl->bytes_cached = 0;
+}
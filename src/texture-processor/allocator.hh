@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tp
+{
+/**
+ * Allocators for image storage
+ *
+ * storages allocate through a tp::allocator (the heap allocator by default), e.g.
+ *
+ *    tp::arena_allocator frame_arena;
+ *    {
+ *        auto scope = frame_arena.scoped();              // everything allocated in this scope is released at its end
+ *        auto tmp = tp::image2<float>::uninitialized({w, h}, frame_arena);
+ *        ...
+ *    }
+ *
+ *    tp::pool_allocator pool;                            // recycles buffers of common texture sizes
+ *    auto mip = tp::image2<tg::color4>::defaulted({512, 512}, pool);
+ *
+ *    tp::huge_page_allocator huge;                       // large images in 2 MiB pages (fewer TLB misses)
+ *    auto heightmap = tp::image2<float>::uninitialized({16384, 16384}, huge);
+ *
+ * all allocators track statistics (see allocator_stats)
+ *
+ * NOTE: allocators must outlive all images that use them
+ * NOTE: allocators are thread-safe (allocation and deallocation are guarded by a mutex)
+ */
+
+struct allocator_stats
+{
+    int64_t bytes_live = 0;  ///< bytes currently handed out
+    int64_t bytes_peak = 0;  ///< maximum of bytes_live
+    int64_t allocations = 0; ///< number of allocate calls
+    int64_t reuses = 0;      ///< allocations served from previously used memory (arena after reset/rewind, pool free lists)
+};
+
+struct allocator
+{
+    virtual ~allocator() = default;
+
+    /// returns at least bytes of memory aligned to alignment (a power of two)
+    virtual std::byte* allocate(size_t bytes, size_t alignment) = 0;
+    /// returns memory obtained from allocate with the same size and alignment
+    virtual void deallocate(std::byte* p, size_t bytes, size_t alignment) = 0;
+
+    virtual allocator_stats stats() const = 0;
+
+    /// the default allocator (global operator new / delete)
+    static allocator& heap();
+};
+
+/// allocates from the global heap (the default for all images)
+struct heap_allocator final : allocator
+{
+    heap_allocator();
+    ~heap_allocator() override;
+    heap_allocator(heap_allocator const&) = delete;
+    heap_allocator& operator=(heap_allocator const&) = delete;
+
+    std::byte* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(std::byte* p, size_t bytes, size_t alignment) override;
+    allocator_stats stats() const override;
+
+private:
+    struct impl;
+    impl* _impl = nullptr;
+};
+
+/// allocates large buffers in huge pages, e.g. for 16k heightmaps or lightmap atlases
+/// with 4 KiB pages, strided column and neighborhood access into such images is dominated by TLB misses
+/// allocations of at least threshold bytes are aligned to and padded to whole huge pages
+/// and advised as transparent huge pages (madvise(MADV_HUGEPAGE) on Linux), smaller allocations are page-aligned
+/// NOTE: on other platforms (or if THP is disabled), this only provides the alignment
+struct huge_page_allocator final : allocator
+{
+    static constexpr size_t page_size = 4 << 10;
+    static constexpr size_t huge_page_size = 2 << 20;
+
+    explicit huge_page_allocator(size_t threshold = huge_page_size);
+    ~huge_page_allocator() override;
+    huge_page_allocator(huge_page_allocator const&) = delete;
+    huge_page_allocator& operator=(huge_page_allocator const&) = delete;
+
+    std::byte* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(std::byte* p, size_t bytes, size_t alignment) override;
+    allocator_stats stats() const override;
+
+private:
+    struct impl;
+    impl* _impl = nullptr;
+};
+
+/// bump allocator for short-lived temporaries (e.g. per-frame scratch images)
+/// allocation is a pointer increment inside large chunks, deallocation only updates the statistics
+/// memory is released all at once via reset() or at the end of a scoped() region, chunks are kept for reuse
+/// NOTE: images must not be used after the memory they live in was reset or rewound
+struct arena_allocator final : allocator
+{
+    /// chunk_size is the minimum size of the chunks requested from the heap
+    explicit arena_allocator(size_t chunk_size = 64 << 20);
+    ~arena_allocator() override;
+    arena_allocator(arena_allocator const&) = delete;
+    arena_allocator& operator=(arena_allocator const&) = delete;
+
+    std::byte* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(std::byte* p, size_t bytes, size_t alignment) override;
+    allocator_stats stats() const override;
+
+    /// releases all allocations (the chunks are kept)
+    void reset();
+
+    /// position in the arena, see rewind
+    struct marker
+    {
+        size_t chunk = 0;
+        size_t offset = 0;
+    };
+    marker mark() const;
+    /// releases all allocations made after m was taken
+    void rewind(marker m);
+
+    /// rewinds the arena to the current position when the scope is destroyed
+    struct scope
+    {
+        explicit scope(arena_allocator& a) : _arena(&a), _marker(a.mark()) {}
+        ~scope() { _arena->rewind(_marker); }
+        scope(scope const&) = delete;
+        scope& operator=(scope const&) = delete;
+
+    private:
+        arena_allocator* _arena;
+        marker _marker;
+    };
+    [[nodiscard]] scope scoped() { return scope(*this); }
+
+    /// returns all chunks to the heap (requires that nothing is allocated)
+    void release_memory();
+
+private:
+    struct impl;
+    impl* _impl = nullptr;
+};
+
+/// recycles buffers in power-of-two size classes (e.g. mip levels and scratch buffers of common texture sizes)
+/// freed buffers are kept in a per-class free list and handed out again for allocations of the same class
+/// NOTE: allocations smaller than min_class_size share the smallest class
+/// NOTE: buffers are aligned to their class size (between 64 and 4096 bytes), allocations that need a larger alignment
+///       bypass the pool and go to the heap directly (e.g. page-aligned images with a small class size)
+struct pool_allocator final : allocator
+{
+    explicit pool_allocator(size_t min_class_size = 4096);
+    ~pool_allocator() override;
+    pool_allocator(pool_allocator const&) = delete;
+    pool_allocator& operator=(pool_allocator const&) = delete;
+
+    std::byte* allocate(size_t bytes, size_t alignment) override;
+    void deallocate(std::byte* p, size_t bytes, size_t alignment) override;
+    allocator_stats stats() const override;
+
+    /// number of bytes held in free lists (not live, but not returned to the heap)
+    int64_t bytes_cached() const;
+
+    /// returns all cached buffers to the heap
+    void trim();
+
+private:
+    struct impl;
+    impl* _impl = nullptr;
+};
+}
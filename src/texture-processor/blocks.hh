@@ -1,14 +1,243 @@
 #pragma once
 
+#include <cmath>
 #include <cstdint>
 
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/detail/bc.hh>
+#include <texture-processor/detail/bc6h.hh>
+#include <texture-processor/detail/bc_encode.hh>
+#include <texture-processor/image_metadata.hh>
+
+// blocks are the storage units of block-compressed images
+// each block type provides:
+//   block_sizes                  - pixels per block in each dimension
+//   format                       - the pixel format of the block (an _srgb format for sRGB blocks)
+//   decode(tg::color4* out)      - decodes all pixels of the block (row-major)
+//   decode_pixel(x, y)           - decodes a single pixel
+//   encode(tg::color4 const* in, quality) - encodes 16 pixels (row-major)
 namespace tp
 {
-/// 4x4 block of 64bit
+/// speed vs. quality tradeoff for block encoding
+enum class bc_quality
+{
+    fast, // range fit
+    high, // cluster fit (and endpoint refinement for single channel blocks), all modes and the best partitions for BC6H
+};
+
+namespace detail
+{
+inline uint64_t bc1_encode(tg::color4 const* in, bc_quality quality, bool allow_punch_through)
+{
+    return quality == bc_quality::high ? bc1_encode_cluster_fit(in, allow_punch_through) : bc1_encode_range_fit(in, allow_punch_through);
+}
+inline uint64_t bc4_encode_channel(tg::color4 const* in, int channel, bc_quality quality)
+{
+    float values[16];
+    for (auto i = 0; i < 16; ++i)
+        values[i] = in[i][channel];
+    return bc4_encode(values, quality == bc_quality::high);
+}
+
+inline float srgb_to_linear(float v) { return v <= 0.04045f ? v * (1 / 12.92f) : std::pow((v + 0.055f) * (1 / 1.055f), 2.4f); }
+inline float linear_to_srgb(float v)
+{
+    v = v < 0.f ? 0.f : v > 1.f ? 1.f : v;
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1 / 2.4f) - 0.055f;
+}
+/// converts the rgb channels of decoded sRGB pixels to linear (alpha is always linear)
+inline void bc_srgb_to_linear(tg::color4* px, int count)
+{
+    for (auto i = 0; i < count; ++i)
+        px[i] = {srgb_to_linear(px[i].r), srgb_to_linear(px[i].g), srgb_to_linear(px[i].b), px[i].a};
+}
+/// encodes linear pixels with the linear block type BlockT after converting them to sRGB
+template <class BlockT>
+void bc_encode_srgb(BlockT& block, tg::color4 const* in, bc_quality quality)
+{
+    tg::color4 px[16];
+    for (auto i = 0; i < 16; ++i)
+        px[i] = {linear_to_srgb(in[i].r), linear_to_srgb(in[i].g), linear_to_srgb(in[i].b), in[i].a};
+    block.encode(px, quality);
+}
+}
+
+/// BC1: 4x4 block of 64bit (RGB + 1 bit alpha)
 struct blockDXT1
 {
     static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc1_8un;
 
     uint64_t data = 0;
+
+    void decode(tg::color4* out) const { detail::bc1_decode(data, out); }
+    tg::color4 decode_pixel(int x, int y) const { return detail::bc1_decode_pixel(data, y * 4 + x); }
+    void encode(tg::color4 const* in, bc_quality quality) { data = detail::bc1_encode(in, quality, true); }
+};
+
+/// BC2: 4x4 block of 128bit (RGB + explicit 4 bit alpha)
+struct blockDXT3
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc2_8un;
+
+    uint64_t alpha = 0;
+    uint64_t color = 0;
+
+    void decode(tg::color4* out) const { detail::bc2_decode(alpha, color, out); }
+    tg::color4 decode_pixel(int x, int y) const { return detail::bc2_decode_pixel(alpha, color, y * 4 + x); }
+    void encode(tg::color4 const* in, bc_quality quality)
+    {
+        alpha = 0;
+        for (auto i = 0; i < 16; ++i)
+        {
+            auto const a = int(in[i].a * 15 + 0.5f);
+            alpha |= uint64_t(a < 0 ? 0 : a > 15 ? 15 : a) << (4 * i);
+        }
+        color = detail::bc1_encode(in, quality, false);
+    }
+};
+
+/// BC3: 4x4 block of 128bit (RGB + interpolated alpha)
+struct blockDXT5
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc3_8un;
+
+    uint64_t alpha = 0;
+    uint64_t color = 0;
+
+    void decode(tg::color4* out) const { detail::bc3_decode(alpha, color, out); }
+    tg::color4 decode_pixel(int x, int y) const { return detail::bc3_decode_pixel(alpha, color, y * 4 + x); }
+    void encode(tg::color4 const* in, bc_quality quality)
+    {
+        alpha = detail::bc4_encode_channel(in, 3, quality);
+        color = detail::bc1_encode(in, quality, false);
+    }
+};
+
+/// sRGB variants of BC1-BC3: same data, but the stored colors are sRGB encoded
+/// pixels are decoded to linear values and encoded from linear values (alpha is always stored linearly)
+struct blockDXT1_sRGB : blockDXT1
+{
+    static constexpr pixel_format format = pixel_format::bc1_8un_srgb;
+
+    void decode(tg::color4* out) const
+    {
+        blockDXT1::decode(out);
+        detail::bc_srgb_to_linear(out, 16);
+    }
+    tg::color4 decode_pixel(int x, int y) const
+    {
+        auto c = blockDXT1::decode_pixel(x, y);
+        detail::bc_srgb_to_linear(&c, 1);
+        return c;
+    }
+    void encode(tg::color4 const* in, bc_quality quality) { detail::bc_encode_srgb<blockDXT1>(*this, in, quality); }
+};
+struct blockDXT3_sRGB : blockDXT3
+{
+    static constexpr pixel_format format = pixel_format::bc2_8un_srgb;
+
+    void decode(tg::color4* out) const
+    {
+        blockDXT3::decode(out);
+        detail::bc_srgb_to_linear(out, 16);
+    }
+    tg::color4 decode_pixel(int x, int y) const
+    {
+        auto c = blockDXT3::decode_pixel(x, y);
+        detail::bc_srgb_to_linear(&c, 1);
+        return c;
+    }
+    void encode(tg::color4 const* in, bc_quality quality) { detail::bc_encode_srgb<blockDXT3>(*this, in, quality); }
+};
+struct blockDXT5_sRGB : blockDXT5
+{
+    static constexpr pixel_format format = pixel_format::bc3_8un_srgb;
+
+    void decode(tg::color4* out) const
+    {
+        blockDXT5::decode(out);
+        detail::bc_srgb_to_linear(out, 16);
+    }
+    tg::color4 decode_pixel(int x, int y) const
+    {
+        auto c = blockDXT5::decode_pixel(x, y);
+        detail::bc_srgb_to_linear(&c, 1);
+        return c;
+    }
+    void encode(tg::color4 const* in, bc_quality quality) { detail::bc_encode_srgb<blockDXT5>(*this, in, quality); }
+};
+
+/// BC4: 4x4 block of 64bit (single channel, decoded to red)
+struct blockBC4
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc4_8un;
+
+    uint64_t data = 0;
+
+    void decode(tg::color4* out) const { detail::bc4_decode(data, out); }
+    tg::color4 decode_pixel(int x, int y) const { return detail::bc4_decode_pixel(data, y * 4 + x); }
+    void encode(tg::color4 const* in, bc_quality quality) { data = detail::bc4_encode_channel(in, 0, quality); }
+};
+
+/// BC5: 4x4 block of 128bit (two channels, decoded to red and green)
+struct blockBC5
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc5_8un;
+
+    uint64_t red = 0;
+    uint64_t green = 0;
+
+    void decode(tg::color4* out) const { detail::bc5_decode(red, green, out); }
+    tg::color4 decode_pixel(int x, int y) const { return detail::bc5_decode_pixel(red, green, y * 4 + x); }
+    void encode(tg::color4 const* in, bc_quality quality)
+    {
+        red = detail::bc4_encode_channel(in, 0, quality);
+        green = detail::bc4_encode_channel(in, 1, quality);
+    }
+};
+
+/// BC6H: 4x4 block of 128bit (unsigned half float RGB, decoded with alpha 1)
+/// values are encoded as half, i.e. negative values become 0 and values above 65504 are clamped
+struct blockBC6H_UF16
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc6h_16uf;
+
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    void decode(tg::color4* out) const { detail::bc6h_decode(lo, hi, false, out); }
+    tg::color4 decode_pixel(int x, int y) const
+    {
+        tg::color4 px[16];
+        detail::bc6h_decode(lo, hi, false, px);
+        return px[y * 4 + x];
+    }
+    void encode(tg::color4 const* in, bc_quality quality) { detail::bc6h_encode(in, false, quality == bc_quality::high, lo, hi); }
+};
+
+/// BC6H: 4x4 block of 128bit (signed half float RGB, decoded with alpha 1)
+struct blockBC6H_SF16
+{
+    static constexpr int block_sizes[] = {4, 4};
+    static constexpr pixel_format format = pixel_format::bc6h_16f;
+
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+
+    void decode(tg::color4* out) const { detail::bc6h_decode(lo, hi, true, out); }
+    tg::color4 decode_pixel(int x, int y) const
+    {
+        tg::color4 px[16];
+        detail::bc6h_decode(lo, hi, true, px);
+        return px[y * 4 + x];
+    }
+    void encode(tg::color4 const* in, bc_quality quality) { detail::bc6h_encode(in, true, quality == bc_quality::high, lo, hi); }
 };
 }
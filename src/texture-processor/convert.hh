@@ -60,6 +60,24 @@ constexpr bool is_floating_point()
 }
 }
 
+namespace detail
+{
+/// calls a pixel converter with either of the supported signatures
+///   (src_pixel const&) -> target_pixel OR
+///   (target_pixel&, src_pixel const&) -> void
+template <class TargetT, class SourceT, class ConverterT>
+void apply_converter(ConverterT&& convert, TargetT&& target, SourceT const& src)
+{
+    using target_t = std::decay_t<TargetT>;
+    if constexpr (std::is_invocable_r_v<target_t, ConverterT, SourceT const&>)
+        target = convert(src);
+    else if constexpr (std::is_invocable_v<ConverterT, TargetT, SourceT const&>)
+        convert(target, src);
+    else
+        static_assert(tg::always_false<TargetT, ConverterT>, "no suitable call syntax found for converter");
+}
+}
+
 /// functor that implements default conversion between pixel types
 /// NOTE: per default, u8 and u16 are seen as [0..1] floats
 /// NOTE: currently needs at least tg/feature/vector for some vector valued conversions
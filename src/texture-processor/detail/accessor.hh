@@ -21,6 +21,8 @@ struct accessor<1, this_t>
     decltype(auto) operator()(int x) const { return static_cast<this_t const*>(this)->at(tg::ipos1(x)); }
 
     auto mirrored_x() const { return static_cast<this_t const*>(this)->template mirrored<0>(); }
+
+    [[nodiscard]] auto broadcasted_x(int n) const { return static_cast<this_t const*>(this)->template broadcasted<0>(n); }
 };
 
 template <class this_t>
@@ -36,6 +38,9 @@ struct accessor<2, this_t>
     [[nodiscard]] auto mirrored_y() const { return static_cast<this_t const*>(this)->template mirrored<1>(); }
 
     [[nodiscard]] auto swapped_xy() const { return static_cast<this_t const*>(this)->template swapped<0, 1>(); }
+
+    [[nodiscard]] auto broadcasted_x(int n) const { return static_cast<this_t const*>(this)->template broadcasted<0>(n); }
+    [[nodiscard]] auto broadcasted_y(int n) const { return static_cast<this_t const*>(this)->template broadcasted<1>(n); }
 };
 
 template <class this_t>
@@ -54,6 +59,10 @@ struct accessor<3, this_t>
     [[nodiscard]] auto swapped_xy() const { return static_cast<this_t const*>(this)->template swapped<0, 1>(); }
     [[nodiscard]] auto swapped_xz() const { return static_cast<this_t const*>(this)->template swapped<0, 2>(); }
     [[nodiscard]] auto swapped_yz() const { return static_cast<this_t const*>(this)->template swapped<1, 2>(); }
+
+    [[nodiscard]] auto broadcasted_x(int n) const { return static_cast<this_t const*>(this)->template broadcasted<0>(n); }
+    [[nodiscard]] auto broadcasted_y(int n) const { return static_cast<this_t const*>(this)->template broadcasted<1>(n); }
+    [[nodiscard]] auto broadcasted_z(int n) const { return static_cast<this_t const*>(this)->template broadcasted<2>(n); }
 };
 
 template <class this_t>
@@ -132,4 +141,40 @@ struct shape_access<extent_cube, this_t>
     [[nodiscard]] auto row(int r, int f) const { return face(f).row(r); }
     [[nodiscard]] auto column(int c, int f) const { return face(f).column(c); }
 };
+template <int W, class this_t>
+struct shape_access<fixed_extent1<W>, this_t>
+{
+    static constexpr int width() { return W; }
+};
+template <int W, int H, class this_t>
+struct shape_access<fixed_extent2<W, H>, this_t>
+{
+    static constexpr int width() { return W; }
+    static constexpr int height() { return H; }
+};
+template <int W, int H, int D, class this_t>
+struct shape_access<fixed_extent3<W, H, D>, this_t>
+{
+    static constexpr int width() { return W; }
+    static constexpr int height() { return H; }
+    static constexpr int depth() { return D; }
+};
+template <class this_t>
+struct shape_access<pow2_extent1, this_t>
+{
+    int width() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_width); }
+};
+template <class this_t>
+struct shape_access<pow2_extent2, this_t>
+{
+    int width() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_width); }
+    int height() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_height); }
+};
+template <class this_t>
+struct shape_access<pow2_extent3, this_t>
+{
+    int width() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_width); }
+    int height() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_height); }
+    int depth() const { return detail::pow2_or_zero(static_cast<this_t const*>(this)->extent().log2_depth); }
+};
 }
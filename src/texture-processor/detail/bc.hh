@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/detail/transpose.hh> // TP_HAS_SSE2
+
+// decoders for the block-compressed (BCn) formats
+// all blocks are 4x4 pixels, pixel i = y * 4 + x is stored at index bits i * bits_per_index
+// values are decoded to normalized floats (the spec allows float interpolation for BC1-5)
+//
+// layouts (little endian):
+//   BC1:  color0 (565) | color1 (565) | 32 bit indices (2 bit per pixel)
+//   BC2:  64 bit explicit alpha (4 bit per pixel) | BC1 color block
+//   BC3:  BC4 alpha block | BC1 color block
+//   BC4:  red0 (8) | red1 (8) | 48 bit indices (3 bit per pixel)
+//   BC5:  BC4 red block | BC4 green block
+namespace tp::detail
+{
+/// expands a 565 color to normalized floats
+inline tg::color4 bc_unpack_565(uint32_t c)
+{
+    return {float((c >> 11) & 31) * (1.f / 31), float((c >> 5) & 63) * (1.f / 63), float(c & 31) * (1.f / 31), 1.f};
+}
+
+/// computes the 4 entry palette of a BC1 color block
+/// four_color_mode is forced for BC2 and BC3 which do not support punch-through alpha
+inline void bc1_palette(uint64_t block, bool force_four_colors, tg::color4 (&palette)[4])
+{
+    auto const c0 = uint32_t(block & 0xFFFF);
+    auto const c1 = uint32_t((block >> 16) & 0xFFFF);
+    palette[0] = bc_unpack_565(c0);
+    palette[1] = bc_unpack_565(c1);
+
+#if TP_HAS_SSE2
+    auto const p0 = _mm_loadu_ps(&palette[0].r);
+    auto const p1 = _mm_loadu_ps(&palette[1].r);
+    if (force_four_colors || c0 > c1)
+    {
+        auto const third = _mm_set1_ps(1.f / 3);
+        auto const two = _mm_set1_ps(2.f);
+        _mm_storeu_ps(&palette[2].r, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(p0, two), p1), third));
+        _mm_storeu_ps(&palette[3].r, _mm_mul_ps(_mm_add_ps(p0, _mm_mul_ps(p1, two)), third));
+    }
+    else
+    {
+        _mm_storeu_ps(&palette[2].r, _mm_mul_ps(_mm_add_ps(p0, p1), _mm_set1_ps(0.5f)));
+        _mm_storeu_ps(&palette[3].r, _mm_setzero_ps());
+    }
+#else
+    auto const& p0 = palette[0];
+    auto const& p1 = palette[1];
+    if (force_four_colors || c0 > c1)
+    {
+        palette[2] = {(2 * p0.r + p1.r) / 3, (2 * p0.g + p1.g) / 3, (2 * p0.b + p1.b) / 3, 1.f};
+        palette[3] = {(p0.r + 2 * p1.r) / 3, (p0.g + 2 * p1.g) / 3, (p0.b + 2 * p1.b) / 3, 1.f};
+    }
+    else
+    {
+        palette[2] = {(p0.r + p1.r) / 2, (p0.g + p1.g) / 2, (p0.b + p1.b) / 2, 1.f};
+        palette[3] = {0.f, 0.f, 0.f, 0.f};
+    }
+#endif
+}
+
+/// computes the 8 entry palette of a BC4 block (unsigned normalized)
+inline void bc4_palette(uint64_t block, float (&palette)[8])
+{
+    auto const a0 = float(block & 0xFF) * (1.f / 255);
+    auto const a1 = float((block >> 8) & 0xFF) * (1.f / 255);
+    palette[0] = a0;
+    palette[1] = a1;
+    if ((block & 0xFF) > ((block >> 8) & 0xFF))
+    {
+        for (auto i = 1; i < 7; ++i)
+            palette[i + 1] = (float(7 - i) * a0 + float(i) * a1) * (1.f / 7);
+    }
+    else
+    {
+        for (auto i = 1; i < 5; ++i)
+            palette[i + 1] = (float(5 - i) * a0 + float(i) * a1) * (1.f / 5);
+        palette[6] = 0.f;
+        palette[7] = 1.f;
+    }
+}
+
+inline int bc1_index(uint64_t block, int i) { return int((block >> (32 + 2 * i)) & 3); }
+inline int bc4_index(uint64_t block, int i) { return int((block >> (16 + 3 * i)) & 7); }
+inline float bc2_alpha(uint64_t alpha_block, int i) { return float((alpha_block >> (4 * i)) & 15) * (1.f / 15); }
+
+/// stores a color with replaced alpha
+inline void bc_store_with_alpha(tg::color4& out, tg::color4 const& c, float a)
+{
+#if TP_HAS_SSE2
+    auto const mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    auto const v = _mm_or_ps(_mm_and_ps(mask, _mm_loadu_ps(&c.r)), _mm_andnot_ps(mask, _mm_set1_ps(a)));
+    _mm_storeu_ps(&out.r, v);
+#else
+    out = {c.r, c.g, c.b, a};
+#endif
+}
+
+//
+// full block decoding (16 pixels, row-major)
+//
+
+inline void bc1_decode(uint64_t block, tg::color4* out)
+{
+    tg::color4 palette[4];
+    bc1_palette(block, false, palette);
+    for (auto i = 0; i < 16; ++i)
+        out[i] = palette[bc1_index(block, i)];
+}
+
+inline void bc2_decode(uint64_t alpha_block, uint64_t color_block, tg::color4* out)
+{
+    tg::color4 palette[4];
+    bc1_palette(color_block, true, palette);
+    for (auto i = 0; i < 16; ++i)
+        bc_store_with_alpha(out[i], palette[bc1_index(color_block, i)], bc2_alpha(alpha_block, i));
+}
+
+inline void bc3_decode(uint64_t alpha_block, uint64_t color_block, tg::color4* out)
+{
+    tg::color4 palette[4];
+    float alpha[8];
+    bc1_palette(color_block, true, palette);
+    bc4_palette(alpha_block, alpha);
+    for (auto i = 0; i < 16; ++i)
+        bc_store_with_alpha(out[i], palette[bc1_index(color_block, i)], alpha[bc4_index(alpha_block, i)]);
+}
+
+inline void bc4_decode(uint64_t block, tg::color4* out)
+{
+    float red[8];
+    bc4_palette(block, red);
+    for (auto i = 0; i < 16; ++i)
+        out[i] = {red[bc4_index(block, i)], 0.f, 0.f, 1.f};
+}
+
+inline void bc5_decode(uint64_t red_block, uint64_t green_block, tg::color4* out)
+{
+    float red[8];
+    float green[8];
+    bc4_palette(red_block, red);
+    bc4_palette(green_block, green);
+    for (auto i = 0; i < 16; ++i)
+        out[i] = {red[bc4_index(red_block, i)], green[bc4_index(green_block, i)], 0.f, 1.f};
+}
+
+//
+// single pixel decoding (i = y * 4 + x)
+//
+
+inline tg::color4 bc1_decode_pixel(uint64_t block, int i)
+{
+    tg::color4 palette[4];
+    bc1_palette(block, false, palette);
+    return palette[bc1_index(block, i)];
+}
+
+inline tg::color4 bc2_decode_pixel(uint64_t alpha_block, uint64_t color_block, int i)
+{
+    tg::color4 palette[4];
+    bc1_palette(color_block, true, palette);
+    auto c = palette[bc1_index(color_block, i)];
+    c.a = bc2_alpha(alpha_block, i);
+    return c;
+}
+
+inline tg::color4 bc3_decode_pixel(uint64_t alpha_block, uint64_t color_block, int i)
+{
+    tg::color4 palette[4];
+    float alpha[8];
+    bc1_palette(color_block, true, palette);
+    bc4_palette(alpha_block, alpha);
+    auto c = palette[bc1_index(color_block, i)];
+    c.a = alpha[bc4_index(alpha_block, i)];
+    return c;
+}
+
+inline tg::color4 bc4_decode_pixel(uint64_t block, int i)
+{
+    float red[8];
+    bc4_palette(block, red);
+    return {red[bc4_index(block, i)], 0.f, 0.f, 1.f};
+}
+
+inline tg::color4 bc5_decode_pixel(uint64_t red_block, uint64_t green_block, int i)
+{
+    float red[8];
+    float green[8];
+    bc4_palette(red_block, red);
+    bc4_palette(green_block, green);
+    return {red[bc4_index(red_block, i)], green[bc4_index(green_block, i)], 0.f, 1.f};
+}
+}
@@ -0,0 +1,686 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/detail/bc_encode.hh>
+
+// BC6H (HDR, 3 channel half float) block decoding and encoding
+//
+// a block is 128 bit, starting with a 2 or 5 bit mode
+// each of the 14 modes has its own endpoint precision, optional delta encoding ("transformed")
+// and either one region (4 bit indices) or two regions (3 bit indices, one of 32 partitions)
+// endpoint bits are scattered over the header in a mode-specific order (see bc6h_layouts)
+//
+// all arithmetic is done in the "unquantized" integer domain of the spec:
+//   unsigned: 0 .. 0xFFFF, finished to half via (v * 31) >> 6
+//   signed:   -0x7FFF .. 0x7FFF, finished to half via (|v| * 31) >> 5 (plus sign bit)
+namespace tp::detail
+{
+//
+// half conversions
+//
+
+inline float half_bits_to_float(uint16_t h)
+{
+    uint32_t const sign = uint32_t(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t f;
+    if (exp == 0)
+    {
+        if (mant == 0)
+            f = sign;
+        else
+        {
+            // subnormal
+            exp = 127 - 15 + 1;
+            while (!(mant & 0x400))
+            {
+                mant <<= 1;
+                --exp;
+            }
+            f = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+        }
+    }
+    else if (exp == 31)
+        f = sign | 0x7F800000 | (mant << 13);
+    else
+        f = sign | ((exp + 112) << 23) | (mant << 13);
+
+    float r;
+    std::memcpy(&r, &f, sizeof(r));
+    return r;
+}
+
+/// round-to-nearest-even float to half, clamped to the largest finite half (BC6H cannot store inf and NaN, NaN becomes 0)
+inline uint16_t float_to_half_bits(float v)
+{
+    uint32_t f;
+    std::memcpy(&f, &v, sizeof(f));
+    auto const sign = uint32_t((f >> 16) & 0x8000);
+    auto const raw_exp = int32_t((f >> 23) & 0xFF);
+    auto mant = f & 0x7FFFFF;
+
+    if (raw_exp == 0xFF)
+        return uint16_t(mant ? 0 : sign | 0x7BFF);
+
+    auto const exp = raw_exp - 127 + 15;
+    if (exp >= 31)
+        return uint16_t(sign | 0x7BFF);
+
+    if (exp <= 0)
+    {
+        if (exp < -10)
+            return uint16_t(sign);
+        mant |= 0x800000;
+        auto const shift = uint32_t(14 - exp);
+        auto h = mant >> shift;
+        auto const rem = mant & ((1u << shift) - 1);
+        auto const half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1)))
+            ++h;
+        return uint16_t(sign | h);
+    }
+
+    auto h = (uint32_t(exp) << 10) | (mant >> 13);
+    auto const rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+        ++h;
+    if (h >= 0x7C00)
+        h = 0x7BFF;
+    return uint16_t(sign | h);
+}
+
+//
+// tables
+//
+
+/// subset masks of the 32 two-region partitions (bit i is the region of pixel i), shared with BC7
+inline constexpr uint16_t bc6h_partitions[32] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000, //
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C, //
+};
+
+/// index of the anchor pixel of the second region (the first region is anchored at pixel 0)
+inline constexpr uint8_t bc6h_anchors[32] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, //
+    15, 2,  8,  2,  2,  8,  8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  //
+};
+
+inline constexpr int bc6h_weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+inline constexpr int bc6h_weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct bc6h_mode_info
+{
+    uint8_t mode_bits;      // value of the mode field
+    uint8_t mode_bit_count; // 2 or 5
+    bool transformed;       // endpoints other than the first are deltas
+    uint8_t regions;        // 1 or 2
+    uint8_t endpoint_bits;
+    uint8_t delta_bits[3];
+};
+
+inline constexpr bc6h_mode_info bc6h_modes[14] = {
+    {0x00, 2, true, 2, 10, {5, 5, 5}},     //
+    {0x01, 2, true, 2, 7, {6, 6, 6}},      //
+    {0x02, 5, true, 2, 11, {5, 4, 4}},     //
+    {0x06, 5, true, 2, 11, {4, 5, 4}},     //
+    {0x0A, 5, true, 2, 11, {4, 4, 5}},     //
+    {0x0E, 5, true, 2, 9, {5, 5, 5}},      //
+    {0x12, 5, true, 2, 8, {6, 5, 5}},      //
+    {0x16, 5, true, 2, 8, {5, 6, 5}},      //
+    {0x1A, 5, true, 2, 8, {5, 5, 6}},      //
+    {0x1E, 5, false, 2, 6, {6, 6, 6}},     //
+    {0x03, 5, false, 1, 10, {10, 10, 10}}, //
+    {0x07, 5, true, 1, 11, {9, 9, 9}},     //
+    {0x0B, 5, true, 1, 12, {8, 8, 8}},     //
+    {0x0F, 5, true, 1, 16, {4, 4, 4}},     //
+};
+
+/// a run of endpoint bits in the header, written as field[a:b] like in the spec
+/// bits are stored starting with bit b and ending with bit a (i.e. [10:11] is stored reversed)
+struct bc6h_segment
+{
+    uint8_t field; // endpoint * 3 + channel, endpoints are w, x (region 0) and y, z (region 1)
+    uint8_t a;
+    uint8_t b;
+};
+
+enum bc6h_field : uint8_t
+{
+    bc6h_rw, bc6h_gw, bc6h_bw, bc6h_rx, bc6h_gx, bc6h_bx, bc6h_ry, bc6h_gy, bc6h_by, bc6h_rz, bc6h_gz, bc6h_bz
+};
+
+struct bc6h_layout
+{
+    uint8_t count;
+    bc6h_segment segments[23];
+};
+
+// clang-format off
+inline constexpr bc6h_layout bc6h_layouts[14] = {
+    {19, {{bc6h_gy,4,4},{bc6h_by,4,4},{bc6h_bz,4,4},{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,4,0},{bc6h_gz,4,4},{bc6h_gy,3,0},{bc6h_gx,4,0},
+          {bc6h_bz,0,0},{bc6h_gz,3,0},{bc6h_bx,4,0},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,4,0},{bc6h_bz,2,2},{bc6h_rz,4,0},{bc6h_bz,3,3}}},
+    {23, {{bc6h_gy,5,5},{bc6h_gz,4,4},{bc6h_gz,5,5},{bc6h_rw,6,0},{bc6h_bz,0,0},{bc6h_bz,1,1},{bc6h_by,4,4},{bc6h_gw,6,0},{bc6h_by,5,5},{bc6h_bz,2,2},
+          {bc6h_gy,4,4},{bc6h_bw,6,0},{bc6h_bz,3,3},{bc6h_bz,5,5},{bc6h_bz,4,4},{bc6h_rx,5,0},{bc6h_gy,3,0},{bc6h_gx,5,0},{bc6h_gz,3,0},{bc6h_bx,5,0},
+          {bc6h_by,3,0},{bc6h_ry,5,0},{bc6h_rz,5,0}}},
+    {18, {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,4,0},{bc6h_rw,10,10},{bc6h_gy,3,0},{bc6h_gx,3,0},{bc6h_gw,10,10},{bc6h_bz,0,0},{bc6h_gz,3,0},
+          {bc6h_bx,3,0},{bc6h_bw,10,10},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,4,0},{bc6h_bz,2,2},{bc6h_rz,4,0},{bc6h_bz,3,3}}},
+    {20, {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,3,0},{bc6h_rw,10,10},{bc6h_gz,4,4},{bc6h_gy,3,0},{bc6h_gx,4,0},{bc6h_gw,10,10},{bc6h_gz,3,0},
+          {bc6h_bx,3,0},{bc6h_bw,10,10},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,3,0},{bc6h_bz,0,0},{bc6h_bz,2,2},{bc6h_rz,3,0},{bc6h_gy,4,4},{bc6h_bz,3,3}}},
+    {20, {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,3,0},{bc6h_rw,10,10},{bc6h_by,4,4},{bc6h_gy,3,0},{bc6h_gx,3,0},{bc6h_gw,10,10},{bc6h_bz,0,0},
+          {bc6h_gz,3,0},{bc6h_bx,4,0},{bc6h_bw,10,10},{bc6h_by,3,0},{bc6h_ry,3,0},{bc6h_bz,1,1},{bc6h_bz,2,2},{bc6h_rz,3,0},{bc6h_bz,4,4},{bc6h_bz,3,3}}},
+    {19, {{bc6h_rw,8,0},{bc6h_by,4,4},{bc6h_gw,8,0},{bc6h_gy,4,4},{bc6h_bw,8,0},{bc6h_bz,4,4},{bc6h_rx,4,0},{bc6h_gz,4,4},{bc6h_gy,3,0},{bc6h_gx,4,0},
+          {bc6h_bz,0,0},{bc6h_gz,3,0},{bc6h_bx,4,0},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,4,0},{bc6h_bz,2,2},{bc6h_rz,4,0},{bc6h_bz,3,3}}},
+    {19, {{bc6h_rw,7,0},{bc6h_gz,4,4},{bc6h_by,4,4},{bc6h_gw,7,0},{bc6h_bz,2,2},{bc6h_gy,4,4},{bc6h_bw,7,0},{bc6h_bz,3,3},{bc6h_bz,4,4},{bc6h_rx,5,0},
+          {bc6h_gy,3,0},{bc6h_gx,4,0},{bc6h_bz,0,0},{bc6h_gz,3,0},{bc6h_bx,4,0},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,5,0},{bc6h_rz,5,0}}},
+    {21, {{bc6h_rw,7,0},{bc6h_bz,0,0},{bc6h_by,4,4},{bc6h_gw,7,0},{bc6h_gy,5,5},{bc6h_gy,4,4},{bc6h_bw,7,0},{bc6h_gz,5,5},{bc6h_bz,4,4},{bc6h_rx,4,0},
+          {bc6h_gz,4,4},{bc6h_gy,3,0},{bc6h_gx,5,0},{bc6h_gz,3,0},{bc6h_bx,4,0},{bc6h_bz,1,1},{bc6h_by,3,0},{bc6h_ry,4,0},{bc6h_bz,2,2},{bc6h_rz,4,0},
+          {bc6h_bz,3,3}}},
+    {21, {{bc6h_rw,7,0},{bc6h_bz,1,1},{bc6h_by,4,4},{bc6h_gw,7,0},{bc6h_by,5,5},{bc6h_gy,4,4},{bc6h_bw,7,0},{bc6h_bz,5,5},{bc6h_bz,4,4},{bc6h_rx,4,0},
+          {bc6h_gz,4,4},{bc6h_gy,3,0},{bc6h_gx,4,0},{bc6h_bz,0,0},{bc6h_gz,3,0},{bc6h_bx,5,0},{bc6h_by,3,0},{bc6h_ry,4,0},{bc6h_bz,2,2},{bc6h_rz,4,0},
+          {bc6h_bz,3,3}}},
+    {23, {{bc6h_rw,5,0},{bc6h_gz,4,4},{bc6h_bz,0,0},{bc6h_bz,1,1},{bc6h_by,4,4},{bc6h_gw,5,0},{bc6h_gy,5,5},{bc6h_by,5,5},{bc6h_bz,2,2},{bc6h_gy,4,4},
+          {bc6h_bw,5,0},{bc6h_gz,5,5},{bc6h_bz,3,3},{bc6h_bz,5,5},{bc6h_bz,4,4},{bc6h_rx,5,0},{bc6h_gy,3,0},{bc6h_gx,5,0},{bc6h_gz,3,0},{bc6h_bx,5,0},
+          {bc6h_by,3,0},{bc6h_ry,5,0},{bc6h_rz,5,0}}},
+    {6,  {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,9,0},{bc6h_gx,9,0},{bc6h_bx,9,0}}},
+    {9,  {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,8,0},{bc6h_rw,10,10},{bc6h_gx,8,0},{bc6h_gw,10,10},{bc6h_bx,8,0},{bc6h_bw,10,10}}},
+    {9,  {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,7,0},{bc6h_rw,10,11},{bc6h_gx,7,0},{bc6h_gw,10,11},{bc6h_bx,7,0},{bc6h_bw,10,11}}},
+    {9,  {{bc6h_rw,9,0},{bc6h_gw,9,0},{bc6h_bw,9,0},{bc6h_rx,3,0},{bc6h_rw,10,15},{bc6h_gx,3,0},{bc6h_gw,10,15},{bc6h_bx,3,0},{bc6h_bw,10,15}}},
+};
+// clang-format on
+
+//
+// bit stream
+//
+
+/// sequential LSB-first access to a 128 bit block
+struct bc6h_bitstream
+{
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    int pos = 0;
+
+    /// reads n <= 32 bits
+    uint32_t read(int n)
+    {
+        uint64_t v;
+        if (pos >= 64)
+            v = hi >> (pos - 64);
+        else if (pos == 0)
+            v = lo;
+        else
+            v = (lo >> pos) | (hi << (64 - pos));
+        pos += n;
+        return uint32_t(v & ((uint64_t(1) << n) - 1));
+    }
+
+    /// writes the lower n <= 32 bits of v
+    void write(uint32_t v, int n)
+    {
+        auto const bits = uint64_t(v) & ((uint64_t(1) << n) - 1);
+        if (pos >= 64)
+            hi |= bits << (pos - 64);
+        else
+        {
+            lo |= bits << pos;
+            if (pos + n > 64)
+                hi |= bits >> (64 - pos);
+        }
+        pos += n;
+    }
+};
+
+//
+// quantization
+//
+
+inline int32_t bc6h_sign_extend(int32_t v, int bits) { return bits >= 32 ? v : int32_t(uint32_t(v) << (32 - bits)) >> (32 - bits); }
+
+inline int32_t bc6h_unquantize(int32_t q, int bits, bool is_signed)
+{
+    if (!is_signed)
+    {
+        if (bits >= 15 || q == 0)
+            return q;
+        if (q == (1 << bits) - 1)
+            return 0xFFFF;
+        return ((q << 16) + 0x8000) >> bits;
+    }
+
+    if (bits >= 16 || q == 0)
+        return q;
+    auto const neg = q < 0;
+    auto const a = neg ? -q : q;
+    int32_t r;
+    if (a >= (1 << (bits - 1)) - 1)
+        r = 0x7FFF;
+    else
+        r = ((a << 15) + 0x4000) >> (bits - 1);
+    return neg ? -r : r;
+}
+
+/// quantizes a domain value to the given endpoint precision (closest unquantized value)
+inline int32_t bc6h_quantize(int32_t v, int bits, bool is_signed)
+{
+    if (!is_signed)
+    {
+        if (bits >= 16)
+            return v;
+        auto const max_q = (1 << bits) - 1;
+        auto q = v >> (16 - bits);
+        if (q < max_q)
+        {
+            auto const d0 = v - bc6h_unquantize(q, bits, false);
+            auto const d1 = bc6h_unquantize(q + 1, bits, false) - v;
+            if (d1 < d0)
+                ++q;
+        }
+        return q;
+    }
+
+    if (bits >= 16)
+        return v;
+    auto const neg = v < 0;
+    auto const a = neg ? -v : v;
+    auto const max_q = (1 << (bits - 1)) - 1;
+    auto q = a >> (16 - bits);
+    if (q > max_q)
+        q = max_q;
+    if (q < max_q)
+    {
+        auto const d0 = a - bc6h_unquantize(q, bits, true);
+        auto const d1 = bc6h_unquantize(q + 1, bits, true) - a;
+        if (d1 < d0)
+            ++q;
+    }
+    return neg ? -q : q;
+}
+
+/// converts an interpolated domain value to half bits
+inline uint16_t bc6h_finish(int32_t v, bool is_signed)
+{
+    if (!is_signed)
+        return uint16_t((v * 31) >> 6);
+    return v < 0 ? uint16_t(0x8000 | (((-v) * 31) >> 5)) : uint16_t((v * 31) >> 5);
+}
+
+/// inverse of bc6h_finish
+inline int32_t bc6h_to_domain(uint16_t h, bool is_signed)
+{
+    if (!is_signed)
+    {
+        if (h & 0x8000)
+            return 0; // negative values are not representable
+        auto const m = int32_t(h < 0x7BFF ? h : 0x7BFF);
+        return (m * 64 + 30) / 31;
+    }
+    auto const m = int32_t((h & 0x7FFF) < 0x7BFF ? (h & 0x7FFF) : 0x7BFF);
+    auto const v = (m * 32 + 30) / 31;
+    return (h & 0x8000) ? -v : v;
+}
+
+inline int32_t bc6h_interpolate(int32_t a, int32_t b, int w) { return ((64 - w) * a + w * b + 32) >> 6; }
+
+//
+// decoding
+//
+
+/// returns the mode index (0..13) or -1 for reserved modes
+inline int bc6h_read_mode(bc6h_bitstream& bs)
+{
+    auto const m2 = bs.read(2);
+    if (m2 < 2)
+        return int(m2);
+
+    auto const m5 = m2 | (bs.read(3) << 2);
+    for (auto i = 2; i < 14; ++i)
+        if (bc6h_modes[i].mode_bits == m5)
+            return i;
+    return -1;
+}
+
+/// decodes all 16 pixels (row-major) of a BC6H block
+inline void bc6h_decode(uint64_t lo, uint64_t hi, bool is_signed, tg::color4* out)
+{
+    bc6h_bitstream bs = {lo, hi};
+    auto const mode = bc6h_read_mode(bs);
+    if (mode < 0)
+    {
+        // reserved modes decode to black
+        for (auto i = 0; i < 16; ++i)
+            out[i] = {0.f, 0.f, 0.f, 1.f};
+        return;
+    }
+
+    auto const& info = bc6h_modes[mode];
+    auto const& layout = bc6h_layouts[mode];
+
+    // endpoints
+    int32_t e[12] = {};
+    for (auto s = 0; s < layout.count; ++s)
+    {
+        auto const& seg = layout.segments[s];
+        if (seg.a >= seg.b)
+            for (auto bit = int(seg.b); bit <= int(seg.a); ++bit)
+                e[seg.field] |= int32_t(bs.read(1)) << bit;
+        else
+            for (auto bit = int(seg.b); bit >= int(seg.a); --bit)
+                e[seg.field] |= int32_t(bs.read(1)) << bit;
+    }
+    auto const partition = info.regions == 2 ? int(bs.read(5)) : 0;
+
+    auto const num_endpoints = info.regions * 2;
+    auto const epb = int(info.endpoint_bits);
+    auto const mask = (1 << epb) - 1;
+    if (is_signed)
+        for (auto c = 0; c < 3; ++c)
+            e[c] = bc6h_sign_extend(e[c], epb);
+    for (auto i = 1; i < num_endpoints; ++i)
+        for (auto c = 0; c < 3; ++c)
+        {
+            auto& v = e[i * 3 + c];
+            if (info.transformed)
+                v = (e[c] + bc6h_sign_extend(v, info.delta_bits[c])) & mask;
+            if (is_signed)
+                v = bc6h_sign_extend(v, epb);
+        }
+    for (auto& v : e)
+        v = bc6h_unquantize(v, epb, is_signed);
+
+    // indices
+    auto const index_bits = info.regions == 2 ? 3 : 4;
+    auto const anchor = info.regions == 2 ? int(bc6h_anchors[partition]) : -1;
+    auto const* weights = info.regions == 2 ? bc6h_weights3 : bc6h_weights4;
+    for (auto i = 0; i < 16; ++i)
+    {
+        auto const idx = int(bs.read(index_bits - (i == 0 || i == anchor ? 1 : 0)));
+        auto const region = info.regions == 2 ? (bc6h_partitions[partition] >> i) & 1 : 0;
+        auto const w = weights[idx];
+        auto const* a = e + region * 6;
+        auto const* b = a + 3;
+        out[i] = {half_bits_to_float(bc6h_finish(bc6h_interpolate(a[0], b[0], w), is_signed)),
+                  half_bits_to_float(bc6h_finish(bc6h_interpolate(a[1], b[1], w), is_signed)),
+                  half_bits_to_float(bc6h_finish(bc6h_interpolate(a[2], b[2], w), is_signed)), 1.f};
+    }
+}
+
+//
+// encoding
+//
+
+/// the pixels of a block in the integer domain
+struct bc6h_block_pixels
+{
+    int32_t v[16][3];
+    tg::color4 f[16]; // same values as floats for endpoint fitting
+};
+
+/// fits endpoints (in the domain) to the pixels where mask is set via range fit along the principal axis
+inline void bc6h_fit_endpoints(bc6h_block_pixels const& px, bool const* mask, bool is_signed, int32_t (&e0)[3], int32_t (&e1)[3])
+{
+    float mean[3];
+    float axis[3];
+    if (bc_principal_axis(px.f, mask, mean, axis) == 0)
+    {
+        for (auto c = 0; c < 3; ++c)
+            e0[c] = e1[c] = 0;
+        return;
+    }
+
+    auto min_t = 1e30f;
+    auto max_t = -1e30f;
+    for (auto i = 0; i < 16; ++i)
+        if (mask[i])
+        {
+            auto const t = (px.f[i].r - mean[0]) * axis[0] + (px.f[i].g - mean[1]) * axis[1] + (px.f[i].b - mean[2]) * axis[2];
+            min_t = t < min_t ? t : min_t;
+            max_t = t > max_t ? t : max_t;
+        }
+
+    auto const len_sq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    auto const s = len_sq > 0.f ? 1.f / len_sq : 0.f;
+    auto const lo = is_signed ? -0x7FFF : 0;
+    auto const hi = is_signed ? 0x7FFF : 0xFFFF;
+    for (auto c = 0; c < 3; ++c)
+    {
+        auto const v0 = int32_t(mean[c] + axis[c] * min_t * s + 0.5f);
+        auto const v1 = int32_t(mean[c] + axis[c] * max_t * s + 0.5f);
+        e0[c] = v0 < lo ? lo : v0 > hi ? hi : v0;
+        e1[c] = v1 < lo ? lo : v1 > hi ? hi : v1;
+    }
+}
+
+/// squared distance of the pixels where mask is set to the line through their principal axis (partition quality estimate)
+inline float bc6h_line_residual(bc6h_block_pixels const& px, bool const* mask)
+{
+    float mean[3];
+    float axis[3];
+    if (bc_principal_axis(px.f, mask, mean, axis) == 0)
+        return 0.f;
+    auto const len_sq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    auto r = 0.f;
+    for (auto i = 0; i < 16; ++i)
+        if (mask[i])
+        {
+            float const d[3] = {px.f[i].r - mean[0], px.f[i].g - mean[1], px.f[i].b - mean[2]};
+            auto const t = d[0] * axis[0] + d[1] * axis[1] + d[2] * axis[2];
+            r += d[0] * d[0] + d[1] * d[1] + d[2] * d[2] - (len_sq > 0.f ? t * t / len_sq : 0.f);
+        }
+    return r;
+}
+
+/// encodes the block with a fixed mode and partition and the given (domain) endpoints per region
+/// returns false if the endpoints cannot be represented (deltas too large)
+inline bool bc6h_encode_mode(bc6h_block_pixels const& px,
+                             int mode,
+                             int partition,
+                             int32_t const (&endpoints)[4][3],
+                             bool is_signed,
+                             uint64_t& lo,
+                             uint64_t& hi,
+                             int64_t& error)
+{
+    auto const& info = bc6h_modes[mode];
+    auto const epb = int(info.endpoint_bits);
+    auto const num_endpoints = info.regions * 2;
+    auto const index_bits = info.regions == 2 ? 3 : 4;
+    auto const num_indices = 1 << index_bits;
+    auto const* weights = info.regions == 2 ? bc6h_weights3 : bc6h_weights4;
+    auto const anchor = info.regions == 2 ? int(bc6h_anchors[partition]) : -1;
+    auto const regions = info.regions == 2 ? bc6h_partitions[partition] : 0;
+
+    // quantize endpoints
+    int32_t q[4][3];
+    for (auto i = 0; i < num_endpoints; ++i)
+        for (auto c = 0; c < 3; ++c)
+            q[i][c] = bc6h_quantize(endpoints[i][c], epb, is_signed);
+
+    // choose indices from the palette that the decoder reconstructs
+    int idx[16];
+    error = 0;
+    for (auto r = 0; r < info.regions; ++r)
+    {
+        int32_t palette[16][3];
+        for (auto c = 0; c < 3; ++c)
+        {
+            auto const a = bc6h_unquantize(q[r * 2][c], epb, is_signed);
+            auto const b = bc6h_unquantize(q[r * 2 + 1][c], epb, is_signed);
+            for (auto k = 0; k < num_indices; ++k)
+                palette[k][c] = bc6h_interpolate(a, b, weights[k]);
+        }
+
+        for (auto i = 0; i < 16; ++i)
+        {
+            if (int((regions >> i) & 1) != r)
+                continue;
+            auto best = 0;
+            auto best_d = INT64_MAX;
+            for (auto k = 0; k < num_indices; ++k)
+            {
+                int64_t d = 0;
+                for (auto c = 0; c < 3; ++c)
+                {
+                    auto const diff = int64_t(px.v[i][c] - palette[k][c]);
+                    d += diff * diff;
+                }
+                if (d < best_d)
+                {
+                    best_d = d;
+                    best = k;
+                }
+            }
+            idx[i] = best;
+            error += best_d;
+        }
+
+        // the anchor index has an implicit leading 0 bit, otherwise the endpoints are swapped
+        auto const anchor_pixel = r == 0 ? 0 : anchor;
+        if (idx[anchor_pixel] >= num_indices / 2)
+        {
+            for (auto c = 0; c < 3; ++c)
+            {
+                auto const t = q[r * 2][c];
+                q[r * 2][c] = q[r * 2 + 1][c];
+                q[r * 2 + 1][c] = t;
+            }
+            for (auto i = 0; i < 16; ++i)
+                if (int((regions >> i) & 1) == r)
+                    idx[i] = num_indices - 1 - idx[i];
+        }
+    }
+
+    // stored endpoint values
+    int32_t e[12];
+    auto const mask = (1 << epb) - 1;
+    for (auto c = 0; c < 3; ++c)
+        e[c] = q[0][c] & mask;
+    for (auto i = 1; i < num_endpoints; ++i)
+        for (auto c = 0; c < 3; ++c)
+        {
+            if (info.transformed)
+            {
+                auto const d = q[i][c] - q[0][c];
+                auto const db = int(info.delta_bits[c]);
+                if (d < -(1 << (db - 1)) || d > (1 << (db - 1)) - 1)
+                    return false;
+                e[i * 3 + c] = d & ((1 << db) - 1);
+            }
+            else
+                e[i * 3 + c] = q[i][c] & mask;
+        }
+
+    // write block
+    bc6h_bitstream bs;
+    bs.write(info.mode_bits, info.mode_bit_count);
+    auto const& layout = bc6h_layouts[mode];
+    for (auto s = 0; s < layout.count; ++s)
+    {
+        auto const& seg = layout.segments[s];
+        if (seg.a >= seg.b)
+            for (auto bit = int(seg.b); bit <= int(seg.a); ++bit)
+                bs.write(uint32_t(e[seg.field] >> bit) & 1, 1);
+        else
+            for (auto bit = int(seg.b); bit >= int(seg.a); --bit)
+                bs.write(uint32_t(e[seg.field] >> bit) & 1, 1);
+    }
+    if (info.regions == 2)
+        bs.write(uint32_t(partition), 5);
+    for (auto i = 0; i < 16; ++i)
+        bs.write(uint32_t(idx[i]), index_bits - (i == 0 || i == anchor ? 1 : 0));
+
+    lo = bs.lo;
+    hi = bs.hi;
+    return true;
+}
+
+/// encodes 16 pixels (row-major, alpha is ignored) into a BC6H block
+/// fast only uses the single region mode with 10 bit endpoints
+/// high quality additionally tries the delta-encoded single region modes and all two region modes for the most promising partitions
+inline void bc6h_encode(tg::color4 const* in, bool is_signed, bool high_quality, uint64_t& lo, uint64_t& hi)
+{
+    bc6h_block_pixels px;
+    for (auto i = 0; i < 16; ++i)
+    {
+        for (auto c = 0; c < 3; ++c)
+            px.v[i][c] = bc6h_to_domain(float_to_half_bits(in[i][c]), is_signed);
+        px.f[i] = {float(px.v[i][0]), float(px.v[i][1]), float(px.v[i][2]), 1.f};
+    }
+
+    bool all[16];
+    for (auto& m : all)
+        m = true;
+
+    int32_t endpoints[4][3];
+    bc6h_fit_endpoints(px, all, is_signed, endpoints[0], endpoints[1]);
+
+    // mode 11 (10 bit, untransformed) can represent any endpoints
+    int64_t best_error;
+    bc6h_encode_mode(px, 10, 0, endpoints, is_signed, lo, hi, best_error);
+    if (!high_quality || best_error == 0)
+        return;
+
+    auto try_mode = [&](int mode, int partition) {
+        uint64_t l;
+        uint64_t h;
+        int64_t e;
+        if (bc6h_encode_mode(px, mode, partition, endpoints, is_signed, l, h, e) && e < best_error)
+        {
+            best_error = e;
+            lo = l;
+            hi = h;
+        }
+    };
+
+    // single region modes with higher precision but limited deltas
+    for (auto mode = 11; mode < 14; ++mode)
+        try_mode(mode, 0);
+
+    // two region modes for the partitions whose regions are closest to lines
+    constexpr auto candidates = 4;
+    int best_partitions[candidates] = {-1, -1, -1, -1};
+    float best_residuals[candidates] = {1e30f, 1e30f, 1e30f, 1e30f};
+    for (auto p = 0; p < 32; ++p)
+    {
+        bool m0[16];
+        bool m1[16];
+        for (auto i = 0; i < 16; ++i)
+        {
+            m1[i] = (bc6h_partitions[p] >> i) & 1;
+            m0[i] = !m1[i];
+        }
+        auto r = bc6h_line_residual(px, m0) + bc6h_line_residual(px, m1);
+        auto pi = p;
+        for (auto k = 0; k < candidates; ++k)
+            if (r < best_residuals[k])
+            {
+                auto const tr = best_residuals[k];
+                auto const tp = best_partitions[k];
+                best_residuals[k] = r;
+                best_partitions[k] = pi;
+                r = tr;
+                pi = tp;
+            }
+    }
+
+    for (auto p : best_partitions)
+    {
+        if (p < 0)
+            continue;
+        bool m0[16];
+        bool m1[16];
+        for (auto i = 0; i < 16; ++i)
+        {
+            m1[i] = (bc6h_partitions[p] >> i) & 1;
+            m0[i] = !m1[i];
+        }
+        bc6h_fit_endpoints(px, m0, is_signed, endpoints[0], endpoints[1]);
+        bc6h_fit_endpoints(px, m1, is_signed, endpoints[2], endpoints[3]);
+        for (auto mode = 0; mode < 10; ++mode)
+            try_mode(mode, p);
+    }
+}
+}
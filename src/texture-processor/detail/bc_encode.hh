@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cstdint>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/detail/bc.hh>
+
+// encoders for the block-compressed (BCn) formats (see detail/bc.hh for the layouts)
+// all encoders take 16 pixels in row-major order (partial blocks must be padded by the caller)
+//
+// BC1 color endpoints are found by
+//   - range fit: the extremes of the pixels projected onto their principal axis (fast)
+//   - cluster fit: least-squares optimal endpoints for every ordered partition of the pixels
+//                  along the principal axis into the 4 palette entries (slower, higher quality)
+// indices are always chosen as the nearest entry of the palette that the decoder reconstructs
+namespace tp::detail
+{
+/// quantizes a normalized color to 565
+inline uint32_t bc_pack_565(float r, float g, float b)
+{
+    auto q = [](float v, int max) {
+        auto const i = int(v * float(max) + 0.5f);
+        return uint32_t(i < 0 ? 0 : i > max ? max : i);
+    };
+    return (q(r, 31) << 11) | (q(g, 63) << 5) | q(b, 31);
+}
+
+/// squared distance of the rgb part of two colors
+inline float bc_rgb_distance_sq(tg::color4 const& a, tg::color4 const& b)
+{
+#if TP_HAS_SSE2
+    auto d = _mm_sub_ps(_mm_loadu_ps(&a.r), _mm_loadu_ps(&b.r));
+    d = _mm_mul_ps(d, d);
+    d = _mm_add_ss(_mm_add_ss(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 2, 2, 2)));
+    return _mm_cvtss_f32(d);
+#else
+    auto const dr = a.r - b.r;
+    auto const dg = a.g - b.g;
+    auto const db = a.b - b.b;
+    return dr * dr + dg * dg + db * db;
+#endif
+}
+
+/// computes the mean and principal axis (via power iteration on the covariance) of the rgb part
+/// only pixels where mask[i] is true are considered, returns the number of considered pixels
+inline int bc_principal_axis(tg::color4 const* px, bool const* mask, float (&mean)[3], float (&axis)[3])
+{
+    auto n = 0;
+    mean[0] = mean[1] = mean[2] = 0.f;
+    for (auto i = 0; i < 16; ++i)
+        if (mask[i])
+        {
+            mean[0] += px[i].r;
+            mean[1] += px[i].g;
+            mean[2] += px[i].b;
+            ++n;
+        }
+    axis[0] = axis[1] = axis[2] = 0.f;
+    if (n == 0)
+        return 0;
+    for (auto& m : mean)
+        m /= float(n);
+
+    // covariance (symmetric)
+    float cov[6] = {};
+    float lo[3] = {1e9f, 1e9f, 1e9f};
+    float hi[3] = {-1e9f, -1e9f, -1e9f};
+    for (auto i = 0; i < 16; ++i)
+        if (mask[i])
+        {
+            float const c[3] = {px[i].r, px[i].g, px[i].b};
+            float const d[3] = {c[0] - mean[0], c[1] - mean[1], c[2] - mean[2]};
+            cov[0] += d[0] * d[0];
+            cov[1] += d[0] * d[1];
+            cov[2] += d[0] * d[2];
+            cov[3] += d[1] * d[1];
+            cov[4] += d[1] * d[2];
+            cov[5] += d[2] * d[2];
+            for (auto k = 0; k < 3; ++k)
+            {
+                lo[k] = c[k] < lo[k] ? c[k] : lo[k];
+                hi[k] = c[k] > hi[k] ? c[k] : hi[k];
+            }
+        }
+
+    // start with the bounding box diagonal, a few iterations are enough for 16 pixels
+    float v[3] = {hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]};
+    for (auto it = 0; it < 8; ++it)
+    {
+        float const w[3] = {
+            cov[0] * v[0] + cov[1] * v[1] + cov[2] * v[2], //
+            cov[1] * v[0] + cov[3] * v[1] + cov[4] * v[2], //
+            cov[2] * v[0] + cov[4] * v[1] + cov[5] * v[2], //
+        };
+        auto m = w[0] * w[0] > w[1] * w[1] ? w[0] : w[1];
+        m = m * m > w[2] * w[2] ? m : w[2];
+        if (m == 0.f)
+            break;
+        for (auto k = 0; k < 3; ++k)
+            v[k] = w[k] / m;
+    }
+    for (auto k = 0; k < 3; ++k)
+        axis[k] = v[k];
+    return n;
+}
+
+/// builds a BC1 color block from the given endpoints and assigns the nearest palette entry to each pixel
+/// if punch_through is true, the 3 color mode is used and transparent pixels (alpha < 0.5) get index 3
+/// otherwise, the 4 color mode is used (force_four_colors for BC2 and BC3 color blocks)
+/// accumulates the squared rgb error into error
+inline uint64_t bc1_build_block(uint32_t c0, uint32_t c1, tg::color4 const* px, bool force_four_colors, bool punch_through, float& error)
+{
+    // select the mode via endpoint order (c0 > c1 means 4 colors)
+    if (punch_through ? c0 > c1 : c0 < c1)
+    {
+        auto const t = c0;
+        c0 = c1;
+        c1 = t;
+    }
+
+    auto block = uint64_t(c0) | uint64_t(c1) << 16;
+    tg::color4 palette[4];
+    bc1_palette(block, force_four_colors, palette);
+    auto const num_colors = (force_four_colors || c0 > c1) ? 4 : 3;
+
+    error = 0.f;
+    uint64_t indices = 0;
+    for (auto i = 0; i < 16; ++i)
+    {
+        auto best = 0;
+        if (punch_through && px[i].a < 0.5f)
+            best = 3;
+        else
+        {
+            auto best_d = bc_rgb_distance_sq(px[i], palette[0]);
+            for (auto k = 1; k < num_colors; ++k)
+            {
+                auto const d = bc_rgb_distance_sq(px[i], palette[k]);
+                if (d < best_d)
+                {
+                    best_d = d;
+                    best = k;
+                }
+            }
+            error += best_d;
+        }
+        indices |= uint64_t(best) << (2 * i);
+    }
+    return block | indices << 32;
+}
+
+/// returns true if any pixel should be encoded as transparent in BC1
+inline bool bc1_has_transparent_pixels(tg::color4 const* px)
+{
+    for (auto i = 0; i < 16; ++i)
+        if (px[i].a < 0.5f)
+            return true;
+    return false;
+}
+
+/// BC1 color block via range fit
+/// allow_punch_through enables 1 bit alpha (only valid for BC1, not for the color part of BC2/BC3)
+inline uint64_t bc1_encode_range_fit(tg::color4 const* px, bool allow_punch_through, float& error)
+{
+    auto const punch_through = allow_punch_through && bc1_has_transparent_pixels(px);
+    bool mask[16];
+    for (auto i = 0; i < 16; ++i)
+        mask[i] = !punch_through || px[i].a >= 0.5f;
+
+    float mean[3];
+    float axis[3];
+    if (bc_principal_axis(px, mask, mean, axis) == 0)
+        return bc1_build_block(0, 0, px, !allow_punch_through, punch_through, error);
+
+    // extremes along the principal axis
+    auto min_t = 1e9f;
+    auto max_t = -1e9f;
+    for (auto i = 0; i < 16; ++i)
+        if (mask[i])
+        {
+            auto const t = (px[i].r - mean[0]) * axis[0] + (px[i].g - mean[1]) * axis[1] + (px[i].b - mean[2]) * axis[2];
+            min_t = t < min_t ? t : min_t;
+            max_t = t > max_t ? t : max_t;
+        }
+
+    auto const axis_len_sq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    auto const s = axis_len_sq > 0.f ? 1.f / axis_len_sq : 0.f;
+    auto const c0 = bc_pack_565(mean[0] + axis[0] * max_t * s, mean[1] + axis[1] * max_t * s, mean[2] + axis[2] * max_t * s);
+    auto const c1 = bc_pack_565(mean[0] + axis[0] * min_t * s, mean[1] + axis[1] * min_t * s, mean[2] + axis[2] * min_t * s);
+    return bc1_build_block(c0, c1, px, !allow_punch_through, punch_through, error);
+}
+inline uint64_t bc1_encode_range_fit(tg::color4 const* px, bool allow_punch_through)
+{
+    float error;
+    return bc1_encode_range_fit(px, allow_punch_through, error);
+}
+
+/// BC1 color block via cluster fit (4 color mode, punch-through blocks fall back to range fit)
+inline uint64_t bc1_encode_cluster_fit(tg::color4 const* px, bool allow_punch_through)
+{
+    if (allow_punch_through && bc1_has_transparent_pixels(px))
+        return bc1_encode_range_fit(px, allow_punch_through);
+
+    bool mask[16];
+    for (auto& m : mask)
+        m = true;
+    float mean[3];
+    float axis[3];
+    bc_principal_axis(px, mask, mean, axis);
+
+    // sort pixels along the principal axis (insertion sort, 16 elements)
+    int order[16];
+    float proj[16];
+    for (auto i = 0; i < 16; ++i)
+    {
+        auto const t = px[i].r * axis[0] + px[i].g * axis[1] + px[i].b * axis[2];
+        auto j = i;
+        while (j > 0 && proj[j - 1] > t)
+        {
+            proj[j] = proj[j - 1];
+            order[j] = order[j - 1];
+            --j;
+        }
+        proj[j] = t;
+        order[j] = i;
+    }
+
+    // prefix sums of the sorted colors
+    float prefix[17][3];
+    prefix[0][0] = prefix[0][1] = prefix[0][2] = 0.f;
+    for (auto i = 0; i < 16; ++i)
+    {
+        auto const& c = px[order[i]];
+        prefix[i + 1][0] = prefix[i][0] + c.r;
+        prefix[i + 1][1] = prefix[i][1] + c.g;
+        prefix[i + 1][2] = prefix[i][2] + c.b;
+    }
+
+    // try all partitions [0,i) -> a, [i,j) -> 2/3 a + 1/3 b, [j,k) -> 1/3 a + 2/3 b, [k,16) -> b
+    // and solve the least squares problem for a and b
+    auto best_error = 1e30f;
+    float best_a[3] = {mean[0], mean[1], mean[2]};
+    float best_b[3] = {mean[0], mean[1], mean[2]};
+    for (auto i = 0; i <= 16; ++i)
+        for (auto j = i; j <= 16; ++j)
+            for (auto k = j; k <= 16; ++k)
+            {
+                auto const n0 = float(i);
+                auto const n1 = float(j - i);
+                auto const n2 = float(k - j);
+                auto const n3 = float(16 - k);
+
+                auto const alpha2 = n0 + n1 * (4.f / 9) + n2 * (1.f / 9);
+                auto const beta2 = n3 + n2 * (4.f / 9) + n1 * (1.f / 9);
+                auto const alphabeta = (n1 + n2) * (2.f / 9);
+                auto const det = alpha2 * beta2 - alphabeta * alphabeta;
+                if (det == 0.f)
+                    continue;
+                auto const inv_det = 1.f / det;
+
+                float a[3];
+                float b[3];
+                for (auto c = 0; c < 3; ++c)
+                {
+                    auto const s0 = prefix[i][c];
+                    auto const s1 = prefix[j][c] - prefix[i][c];
+                    auto const s2 = prefix[k][c] - prefix[j][c];
+                    auto const s3 = prefix[16][c] - prefix[k][c];
+                    auto const alphax = s0 + s1 * (2.f / 3) + s2 * (1.f / 3);
+                    auto const betax = s3 + s2 * (2.f / 3) + s1 * (1.f / 3);
+                    a[c] = (alphax * beta2 - betax * alphabeta) * inv_det;
+                    b[c] = (betax * alpha2 - alphax * alphabeta) * inv_det;
+                    a[c] = a[c] < 0.f ? 0.f : a[c] > 1.f ? 1.f : a[c];
+                    b[c] = b[c] < 0.f ? 0.f : b[c] > 1.f ? 1.f : b[c];
+                }
+
+                // error up to the constant sum of squared colors
+                auto e = 0.f;
+                for (auto c = 0; c < 3; ++c)
+                {
+                    auto const s0 = prefix[i][c];
+                    auto const s1 = prefix[j][c] - prefix[i][c];
+                    auto const s2 = prefix[k][c] - prefix[j][c];
+                    auto const s3 = prefix[16][c] - prefix[k][c];
+                    auto const alphax = s0 + s1 * (2.f / 3) + s2 * (1.f / 3);
+                    auto const betax = s3 + s2 * (2.f / 3) + s1 * (1.f / 3);
+                    e += a[c] * a[c] * alpha2 + b[c] * b[c] * beta2 + 2 * a[c] * b[c] * alphabeta - 2 * (a[c] * alphax + b[c] * betax);
+                }
+
+                if (e < best_error)
+                {
+                    best_error = e;
+                    for (auto c = 0; c < 3; ++c)
+                    {
+                        best_a[c] = a[c];
+                        best_b[c] = b[c];
+                    }
+                }
+            }
+
+    float error;
+    auto const ca = bc_pack_565(best_a[0], best_a[1], best_a[2]);
+    auto const cb = bc_pack_565(best_b[0], best_b[1], best_b[2]);
+    auto const block = bc1_build_block(ca, cb, px, !allow_punch_through, false, error);
+
+    // quantization can make the cluster fit worse than the range fit
+    float range_error;
+    auto const range_block = bc1_encode_range_fit(px, allow_punch_through, range_error);
+    return range_error < error ? range_block : block;
+}
+
+/// builds a BC4 block for the given endpoints, assigning the nearest palette entry
+inline uint64_t bc4_build_block(int a0, int a1, float const* values, float& error)
+{
+    auto block = uint64_t(a0) | uint64_t(a1) << 8;
+    float palette[8];
+    bc4_palette(block, palette);
+
+    error = 0.f;
+    for (auto i = 0; i < 16; ++i)
+    {
+        auto best = 0;
+        auto best_d = (values[i] - palette[0]) * (values[i] - palette[0]);
+        for (auto k = 1; k < 8; ++k)
+        {
+            auto const d = (values[i] - palette[k]) * (values[i] - palette[k]);
+            if (d < best_d)
+            {
+                best_d = d;
+                best = k;
+            }
+        }
+        error += best_d;
+        block |= uint64_t(best) << (16 + 3 * i);
+    }
+    return block;
+}
+
+/// BC4 block (also used for BC3 alpha and the two BC5 channels)
+/// high quality additionally tries the 6 value mode (with explicit 0 and 1) and refines the endpoints
+inline uint64_t bc4_encode(float const* values, bool high_quality)
+{
+    auto q = [](float v) {
+        auto const i = int(v * 255 + 0.5f);
+        return i < 0 ? 0 : i > 255 ? 255 : i;
+    };
+
+    auto lo = 1e9f;
+    auto hi = -1e9f;
+    for (auto i = 0; i < 16; ++i)
+    {
+        lo = values[i] < lo ? values[i] : lo;
+        hi = values[i] > hi ? values[i] : hi;
+    }
+
+    // 8 value mode requires a0 > a1
+    auto const qlo = q(lo);
+    auto const qhi = q(hi);
+    float best_error;
+    auto best = bc4_build_block(qhi, qlo, values, best_error);
+    if (!high_quality || best_error == 0.f)
+        return best;
+
+    auto try_block = [&](int a0, int a1) {
+        if (a0 < 0 || a0 > 255 || a1 < 0 || a1 > 255)
+            return;
+        float e;
+        auto const b = bc4_build_block(a0, a1, values, e);
+        if (e < best_error)
+        {
+            best_error = e;
+            best = b;
+        }
+    };
+
+    // refine endpoints of the 8 value mode
+    for (auto d0 = -2; d0 <= 2; ++d0)
+        for (auto d1 = -2; d1 <= 2; ++d1)
+            if (qhi + d0 > qlo + d1)
+                try_block(qhi + d0, qlo + d1);
+
+    // 6 value mode (a0 <= a1), extremes 0 and 1 are represented exactly
+    auto inner_lo = 1e9f;
+    auto inner_hi = -1e9f;
+    for (auto i = 0; i < 16; ++i)
+        if (values[i] > 0.f && values[i] < 1.f)
+        {
+            inner_lo = values[i] < inner_lo ? values[i] : inner_lo;
+            inner_hi = values[i] > inner_hi ? values[i] : inner_hi;
+        }
+    if (inner_lo <= inner_hi)
+        try_block(q(inner_lo), q(inner_hi));
+    else
+        try_block(0, 0);
+
+    return best;
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <texture-processor/convert.hh>
+
+// helpers for images with a runtime channel count (see base_traits::dynamic_channels)
+namespace tp::detail
+{
+/// calls f(std::integral_constant<int, N>{}) with N = channels for the common counts 1..4 and N = 0 for all others
+/// kernels use N as compile-time channel count if it is non-zero, so that their channel loops can be unrolled
+template <class F>
+decltype(auto) dispatch_channel_count(int channels, F&& f)
+{
+    switch (channels)
+    {
+    case 1:
+        return f(std::integral_constant<int, 1>{});
+    case 2:
+        return f(std::integral_constant<int, 2>{});
+    case 3:
+        return f(std::integral_constant<int, 3>{});
+    case 4:
+        return f(std::integral_constant<int, 4>{});
+    default:
+        return f(std::integral_constant<int, 0>{});
+    }
+}
+
+/// copies count pixels of interleaved channels, each channel is converted individually
+/// N is the compile-time channel count (0 means the runtime value channels is used)
+template <int N, class TargetT, class SourceT, class ConverterT>
+void copy_channel_run(std::byte* dst, int64_t dst_step, std::byte const* src, int64_t src_step, int count, int channels, ConverterT&& convert)
+{
+    auto const c = N > 0 ? N : channels;
+    for (auto i = 0; i < count; ++i, dst += dst_step, src += src_step)
+    {
+        auto const s = reinterpret_cast<SourceT const*>(src);
+        auto const d = reinterpret_cast<TargetT*>(dst);
+        for (auto k = 0; k < c; ++k)
+            apply_converter(convert, d[k], s[k]);
+    }
+}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include <clean-core/assert.hh>
+#include <clean-core/forward.hh>
+#include <clean-core/move.hh>
+
+namespace tp::detail
+{
+/// holds a functor (e.g. a lambda) with value semantics that closure types lack
+/// (views are default constructed and assigned member-wise, see image_view::subview)
+template <class F>
+struct functor_storage
+{
+    functor_storage() = default;
+    explicit functor_storage(F f)
+    {
+        new (_data) F(cc::move(f));
+        _valid = true;
+    }
+    functor_storage(functor_storage const& rhs)
+    {
+        if (rhs._valid)
+        {
+            new (_data) F(*rhs.ptr());
+            _valid = true;
+        }
+    }
+    functor_storage& operator=(functor_storage const& rhs)
+    {
+        if (this != &rhs)
+        {
+            reset();
+            if (rhs._valid)
+            {
+                new (_data) F(*rhs.ptr());
+                _valid = true;
+            }
+        }
+        return *this;
+    }
+    ~functor_storage() { reset(); }
+
+    template <class... Args>
+    decltype(auto) operator()(Args&&... args) const
+    {
+        CC_ASSERT(_valid && "functor not set");
+        return (*ptr())(cc::forward<Args>(args)...);
+    }
+
+private:
+    F const* ptr() const { return std::launder(reinterpret_cast<F const*>(_data)); }
+    void reset()
+    {
+        if (_valid)
+            ptr()->~F();
+        _valid = false;
+    }
+
+    alignas(F) std::byte _data[sizeof(F)];
+    bool _valid = false;
+};
+
+/// setter of read-only procedural views
+struct no_setter
+{
+};
+}
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include <clean-core/always_false.hh>
+#include <clean-core/assert.hh>
 #include <clean-core/sentinel.hh>
+#include <clean-core/span.hh>
 
 #include <typed-geometry/tg-lean.hh>
 
+#include <texture-processor/convert.hh>
+#include <texture-processor/detail/morton.hh>
 #include <texture-processor/detail/predicates.hh>
 
 namespace tp
@@ -15,6 +22,48 @@ struct pixel_entry
     tg::pos<D, int> const pos;
     PixelT pixel;
 };
+
+/// a run of pixels along a single dimension of a strided linear image
+/// runs are always in ascending memory order, i.e. byte_stride is non-negative
+/// if the dimension is mirrored, pos is the position of the last pixel of the row and pos_step is -1
+/// usage:
+///    for (auto const& r : img.rows())
+///        if (r.is_contiguous())
+///            for (auto& v : r.span())
+///                v = ...;
+template <int D, class PixelT>
+struct pixel_run
+{
+    using data_ptr_t = std::conditional_t<std::is_const_v<PixelT>, std::byte const*, std::byte*>;
+
+    data_ptr_t data = nullptr; // first pixel of the run in memory
+    tg::pos<D, int> pos;       // position of the first pixel
+    int size = 0;              // number of pixels
+    int byte_stride = 0;       // distance between two pixels in bytes
+    int dim = 0;               // image dimension along which this run extends
+    int pos_step = 1;          // +1 or -1
+
+    /// returns true if the pixels of this run are densely packed
+    bool is_contiguous() const { return byte_stride == int(sizeof(PixelT)); }
+
+    /// returns the run as a span (only valid for contiguous runs)
+    cc::span<PixelT> span() const
+    {
+        CC_ASSERT(is_contiguous() && "only contiguous runs can be converted to spans");
+        return {reinterpret_cast<PixelT*>(data), size_t(size)};
+    }
+
+    /// returns the i-th pixel of this run
+    PixelT& operator[](int i) const { return *reinterpret_cast<PixelT*>(data + int64_t(i) * byte_stride); }
+
+    /// returns the position of the i-th pixel of this run
+    tg::pos<D, int> pos_at(int i) const
+    {
+        auto p = pos;
+        p[dim] += i * pos_step;
+        return p;
+    }
+};
 }
 
 namespace tp::detail
@@ -29,38 +78,76 @@ struct srange
     cc::sentinel end() const { return {}; }
 };
 
-// TODO: can probably be optimized further
+/// computes the order in which dimensions are traversed (smallest absolute stride first)
+/// order[i] is the image dimension that is the i-th innermost dimension in memory
+/// NOTE: ties are resolved in favor of the lower dimension
+/// NOTE: zero strides (broadcast dimensions) are outermost, so that inner loops run over actual memory
+template <int D>
+void compute_stride_order(tg::vec<D, int> const& byte_stride, uint8_t (&order)[D])
+{
+    static_assert(1 <= D && D <= 4, "dimension not supported");
+
+    uint32_t abs_stride[D];
+    for (auto i = 0; i < D; ++i)
+    {
+        abs_stride[i] = byte_stride[i] > 0 ? uint32_t(byte_stride[i]) : byte_stride[i] < 0 ? uint32_t(-int64_t(byte_stride[i])) : UINT32_MAX;
+        order[i] = uint8_t(i);
+    }
+
+    // insertion sort (stable and optimal for D <= 4)
+    for (auto i = 1; i < D; ++i)
+    {
+        auto const o = order[i];
+        auto j = i;
+        for (; j > 0 && abs_stride[order[j - 1]] > abs_stride[o]; --j)
+            order[j] = order[j - 1];
+        order[j] = o;
+    }
+}
+
+/// returns the image dimension with the smallest absolute stride
+template <int D>
+int innermost_dimension(tg::vec<D, int> const& byte_stride)
+{
+    uint8_t order[D];
+    compute_stride_order(byte_stride, order);
+    return order[0];
+}
+
+/// calls f(ipos, index) for all positions of a fixed extent in memory order (index is the row-major pixel index)
+/// all loop bounds are compile-time constants
+template <class ExtentT, class F>
+void for_each_fixed_index(F&& f)
+{
+    if constexpr (ExtentT::dimensions == 1)
+    {
+        for (auto x = 0; x < ExtentT::width; ++x)
+            f(tg::ipos1(x), int64_t(x));
+    }
+    else if constexpr (ExtentT::dimensions == 2)
+    {
+        for (auto y = 0; y < ExtentT::height; ++y)
+            for (auto x = 0; x < ExtentT::width; ++x)
+                f(tg::ipos2(x, y), int64_t(y) * ExtentT::width + x);
+    }
+    else
+    {
+        static_assert(ExtentT::dimensions == 3, "unsupported fixed extent");
+        for (auto z = 0; z < ExtentT::depth; ++z)
+            for (auto y = 0; y < ExtentT::height; ++y)
+                for (auto x = 0; x < ExtentT::width; ++x)
+                    f(tg::ipos3(x, y, z), (int64_t(z) * ExtentT::height + y) * ExtentT::width + x);
+    }
+}
+
 template <int D>
 struct strided_linear_pos_iterator
 {
     strided_linear_pos_iterator(tg::vec<D, int> byte_stride, tg::vec<D, int> extent)
     {
-        if constexpr (D == 1)
-        {
-            (void)byte_stride; // unused
-            _extent[0] = extent.x;
-        }
-        else if constexpr (D == 2)
-        {
-            auto s0 = byte_stride.x >= 0 ? byte_stride.x : -byte_stride.x;
-            auto s1 = byte_stride.y >= 0 ? byte_stride.y : -byte_stride.y;
-            if (s0 <= s1)
-            {
-                _extent[0] = extent.x;
-                _extent[1] = extent.y;
-                _order[0] = 0;
-                _order[1] = 1;
-            }
-            else
-            {
-                _extent[0] = extent.y;
-                _extent[1] = extent.x;
-                _order[0] = 1;
-                _order[1] = 0;
-            }
-        }
-        else
-            static_assert(cc::always_false_v<D>, "dimension not supported / implemented");
+        compute_stride_order(byte_stride, _order);
+        for (auto i = 0; i < D; ++i)
+            _extent[i] = extent[_order[i]];
 
         if (detail::is_any_zero(extent))
             _extent[D - 1] = 0;
@@ -68,16 +155,10 @@ struct strided_linear_pos_iterator
 
     tg::pos<D, int> operator*() const
     {
-        if constexpr (D == 1)
-            return {_idx[0]};
-        else if constexpr (D == 2)
-            return {_idx[_order[0]], _idx[_order[1]]};
-        else if constexpr (D == 3)
-            return {_idx[_order[0]], _idx[_order[1]], _idx[_order[2]]};
-        else if constexpr (D == 4)
-            return {_idx[_order[0]], _idx[_order[1]], _idx[_order[2]], _idx[_order[3]]};
-        else
-            static_assert(cc::always_false_v<D>, "dimension not supported");
+        tg::pos<D, int> p;
+        for (auto i = 0; i < D; ++i)
+            p[_order[i]] = _idx[i];
+        return p;
     }
 
     void operator++()
@@ -120,50 +201,643 @@ private:
     uint8_t _order[D];
 };
 
-// TODO: can be optimized by sharing stride and extent with pos iterator
+/// enumerates all rows of a strided linear image, i.e. the runs along the dimension with the smallest stride
+/// each row is returned as a pixel_run in ascending memory order
+/// NOTE: rows of a mirrored dimension start at their last pixel (pos_step is -1 then)
+///
+/// if merge_rows is true, consecutive dimensions that are contiguous in memory are merged into a single run
+/// (e.g. a compact image is a single run)
+/// in that case, only data, size, and byte_stride of the runs are meaningful (not pos)
+template <int D, class StorageViewT>
+struct strided_linear_row_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using run_t = pixel_run<D, typename StorageViewT::pixel_t>;
+
+    strided_linear_row_iterator(data_ptr_t data, tg::vec<D, int> byte_stride, tg::vec<D, int> extent, bool merge_rows = false)
+    {
+        compute_stride_order(byte_stride, _order);
+        for (auto i = 0; i < D; ++i)
+        {
+            _extent[i] = extent[_order[i]];
+            _byte_stride[i] = byte_stride[_order[i]];
+        }
+
+        _done = detail::is_any_zero(extent);
+
+        _run.data = data;
+        _run.pos = {};
+        _run.size = _extent[0];
+        _run.byte_stride = _byte_stride[0];
+        _run.dim = _order[0];
+        _run.pos_step = 1;
+
+        // make inner dimension ascending in memory
+        if (_run.byte_stride < 0 && !_done)
+        {
+            _run.data += int64_t(_run.byte_stride) * (_run.size - 1);
+            _run.pos[_run.dim] = _run.size - 1;
+            _run.byte_stride = -_run.byte_stride;
+            _run.pos_step = -1;
+        }
+
+        // merge contiguous dimensions into the run
+        // (outer dimensions are shifted down, merged ones become extent 1)
+        if (merge_rows && !_done)
+        {
+            auto d = 1;
+            while (d < D && int64_t(_byte_stride[d]) == int64_t(_run.byte_stride) * _run.size && int64_t(_run.size) * _extent[d] <= INT32_MAX)
+            {
+                _run.size *= _extent[d];
+                ++d;
+            }
+
+            auto const merged = d - 1;
+            for (auto i = 1; i < D; ++i)
+            {
+                auto const src = i + merged;
+                _extent[i] = src < D ? _extent[src] : 1;
+                _byte_stride[i] = src < D ? _byte_stride[src] : 0;
+                _order[i] = src < D ? _order[src] : _order[0];
+            }
+        }
+
+        // track outer indices independently of the run position (which is meaningless for merged runs)
+        for (auto& i : _idx)
+            i = 0;
+    }
+
+    run_t const& operator*() const { return _run; }
+
+    void operator++()
+    {
+        for (auto i = 1; i < D; ++i)
+        {
+            _run.data += _byte_stride[i];
+            ++_run.pos[_order[i]];
+            if (++_idx[i] < _extent[i])
+                return;
+
+            _run.data -= int64_t(_byte_stride[i]) * _extent[i];
+            _run.pos[_order[i]] -= _extent[i];
+            _idx[i] = 0;
+        }
+
+        _done = true;
+    }
+
+    bool operator!=(cc::sentinel) const { return !_done; }
+
+private:
+    run_t _run;
+    int _idx[D];
+    int _extent[D];
+    int _byte_stride[D];
+    uint8_t _order[D];
+    bool _done;
+};
+
+/// visits all pixels row by row, where the inner loop is a simple pointer increment
+/// NOTE: contiguous rows are merged, e.g. a compact image is visited as a single flat loop
 template <int D, class StorageViewT>
 struct strided_linear_pixel_iterator
 {
     using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
 
     strided_linear_pixel_iterator(data_ptr_t data, tg::vec<D, int> byte_stride, tg::vec<D, int> extent)
-      : _pos_it(byte_stride, extent), _data(data), _byte_stride(byte_stride)
+      : _rows(data, byte_stride, extent, true /* merge rows */)
     {
+        load_row();
     }
 
-    typename StorageViewT::pixel_access_t operator*() const { return StorageViewT::pixel_at(_data, *_pos_it, _byte_stride); }
-    void operator++() { ++_pos_it; }
-    bool operator!=(cc::sentinel) const { return _pos_it != cc::sentinel{}; }
+    typename StorageViewT::pixel_access_t operator*() const { return *reinterpret_cast<pixel_t*>(_data); }
+    void operator++()
+    {
+        _data += _byte_stride;
+        if (--_remaining == 0)
+        {
+            ++_rows;
+            load_row();
+        }
+    }
+    bool operator!=(cc::sentinel) const { return _rows != cc::sentinel{}; }
 
 private:
-    strided_linear_pos_iterator<D> _pos_it;
-    data_ptr_t _data;
-    tg::vec<D, int> _byte_stride;
+    void load_row()
+    {
+        if (_rows != cc::sentinel{})
+        {
+            auto const& r = *_rows;
+            _data = r.data;
+            _byte_stride = r.byte_stride;
+            _remaining = r.size;
+        }
+    }
+
+    strided_linear_row_iterator<D, StorageViewT> _rows;
+    data_ptr_t _data = nullptr;
+    int _byte_stride = 0;
+    int _remaining = 0;
 };
 
-// TODO: can be optimized by sharing stride and extent with pos iterator
+/// same as strided_linear_pixel_iterator but additionally tracks the pixel position
 template <int D, class StorageViewT>
 struct strided_linear_entry_iterator
 {
     using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
+    using pixel_access_t = typename StorageViewT::pixel_access_t;
+
+    strided_linear_entry_iterator(data_ptr_t data, tg::vec<D, int> byte_stride, tg::vec<D, int> extent) : _rows(data, byte_stride, extent)
+    {
+        load_row();
+    }
+
+    pixel_entry<D, pixel_access_t> operator*() const { return {_pos, *reinterpret_cast<pixel_t*>(_data)}; }
+    void operator++()
+    {
+        _data += _byte_stride;
+        _pos[_dim] += _pos_step;
+        if (--_remaining == 0)
+        {
+            ++_rows;
+            load_row();
+        }
+    }
+    bool operator!=(cc::sentinel) const { return _rows != cc::sentinel{}; }
+
+private:
+    void load_row()
+    {
+        if (_rows != cc::sentinel{})
+        {
+            auto const& r = *_rows;
+            _data = r.data;
+            _pos = r.pos;
+            _byte_stride = r.byte_stride;
+            _remaining = r.size;
+            _dim = r.dim;
+            _pos_step = r.pos_step;
+        }
+    }
+
+    strided_linear_row_iterator<D, StorageViewT> _rows;
+    data_ptr_t _data = nullptr;
+    tg::pos<D, int> _pos;
+    int _byte_stride = 0;
+    int _remaining = 0;
+    int _dim = 0;
+    int _pos_step = 1;
+};
+
+/// walks a 2D Z-order layout in memory order
+/// stride is {pixel size in bytes, number of interleaved bits} (see z_storage_view)
+/// indices that map outside of the extent (padding of non-power-of-two images) are skipped
+struct z_order_cursor
+{
+    z_order_cursor(tg::ivec2 stride, tg::ivec2 extent)
+      : _extent(extent), _k(stride.y), _high_is_x(int64_t(extent.x) > (int64_t(1) << stride.y))
+    {
+        _end = detail::is_any_zero(extent) ? 0 : detail::morton_index(extent.x - 1, extent.y - 1, _k) + 1;
+        _idx = 0;
+        skip_padding();
+    }
+
+    void operator++()
+    {
+        ++_idx;
+        skip_padding();
+    }
+
+    bool is_done() const { return _idx >= _end; }
+    uint64_t index() const { return _idx; }
+    tg::ipos2 pos() const { return {_x, _y}; }
+
+private:
+    void skip_padding()
+    {
+        while (_idx < _end)
+        {
+            detail::morton_decode(_idx, _k, _high_is_x, _x, _y);
+            if (_x < _extent.x && _y < _extent.y)
+                return;
+            ++_idx;
+        }
+    }
+
+    tg::ivec2 _extent;
+    int _k;
+    bool _high_is_x;
+    int _x = 0;
+    int _y = 0;
+    uint64_t _idx;
+    uint64_t _end;
+};
+
+/// enumerates all positions of a Z-order image in memory order
+struct z_order_pos_iterator
+{
+    z_order_pos_iterator(tg::ivec2 stride, tg::ivec2 extent) : _cursor(stride, extent) {}
+
+    tg::ipos2 operator*() const { return _cursor.pos(); }
+    void operator++() { ++_cursor; }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    z_order_cursor _cursor;
+};
+
+/// visits all pixels of a Z-order image in memory order
+template <class StorageViewT>
+struct z_order_pixel_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
+
+    z_order_pixel_iterator(data_ptr_t data, tg::ivec2 stride, tg::ivec2 extent) : _data(data), _pixel_stride(stride.x), _cursor(stride, extent) {}
+
+    typename StorageViewT::pixel_access_t operator*() const { return *reinterpret_cast<pixel_t*>(_data + int64_t(_cursor.index()) * _pixel_stride); }
+    void operator++() { ++_cursor; }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    data_ptr_t _data;
+    int _pixel_stride;
+    z_order_cursor _cursor;
+};
+
+/// same as z_order_pixel_iterator but additionally provides the pixel position
+template <class StorageViewT>
+struct z_order_entry_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
     using pixel_access_t = typename StorageViewT::pixel_access_t;
 
-    strided_linear_entry_iterator(data_ptr_t data, tg::vec<D, int> byte_stride, tg::vec<D, int> extent)
-      : _pos_it(byte_stride, extent), _data(data), _byte_stride(byte_stride)
+    z_order_entry_iterator(data_ptr_t data, tg::ivec2 stride, tg::ivec2 extent) : _data(data), _pixel_stride(stride.x), _cursor(stride, extent) {}
+
+    pixel_entry<2, pixel_access_t> operator*() const
     {
+        return {_cursor.pos(), *reinterpret_cast<pixel_t*>(_data + int64_t(_cursor.index()) * _pixel_stride)};
     }
+    void operator++() { ++_cursor; }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    data_ptr_t _data;
+    int _pixel_stride;
+    z_order_cursor _cursor;
+};
+
+/// visits all pixels in memory order of the positions, each pixel is obtained via StorageViewT::pixel_at
+/// (used for storages whose pixel access is not a plain reference, e.g. runtime channel counts or planar images)
+template <int D, class StorageViewT>
+struct addressed_pixel_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using stride_t = typename StorageViewT::stride_t;
+
+    addressed_pixel_iterator(data_ptr_t data, stride_t const& stride, tg::vec<D, int> extent) : _data(data), _stride(stride), _pos(stride, extent) {}
+
+    typename StorageViewT::pixel_access_t operator*() const { return StorageViewT::pixel_at(_data, *_pos, _stride); }
+    void operator++() { ++_pos; }
+    bool operator!=(cc::sentinel s) const { return _pos != s; }
+
+private:
+    data_ptr_t _data;
+    stride_t _stride;
+    strided_linear_pos_iterator<D> _pos;
+};
+
+/// same as addressed_pixel_iterator but additionally provides the pixel position
+template <int D, class StorageViewT>
+struct addressed_entry_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using stride_t = typename StorageViewT::stride_t;
+    using pixel_access_t = typename StorageViewT::pixel_access_t;
+
+    addressed_entry_iterator(data_ptr_t data, stride_t const& stride, tg::vec<D, int> extent) : _data(data), _stride(stride), _pos(stride, extent) {}
 
     pixel_entry<D, pixel_access_t> operator*() const
     {
-        auto pos = *_pos_it;
-        return {pos, StorageViewT::pixel_at(_data, pos, _byte_stride)};
+        auto const p = *_pos;
+        return {p, StorageViewT::pixel_at(_data, p, _stride)};
+    }
+    void operator++() { ++_pos; }
+    bool operator!=(cc::sentinel s) const { return _pos != s; }
+
+private:
+    data_ptr_t _data;
+    stride_t _stride;
+    strided_linear_pos_iterator<D> _pos;
+};
+
+/// walks a row-major block image block by block (pixels inside a block are row-major)
+/// pixels outside of the extent (partial blocks at the border) are skipped
+template <int BlockW, int BlockH>
+struct block_cursor
+{
+    explicit block_cursor(tg::ivec2 extent) : _extent(extent) { _done = detail::is_any_zero(extent); }
+
+    void operator++()
+    {
+        do
+        {
+            if (++_in_block.x < BlockW)
+                continue;
+            _in_block.x = 0;
+            if (++_in_block.y < BlockH)
+                continue;
+            _in_block.y = 0;
+
+            _block.x += BlockW;
+            if (_block.x >= _extent.x)
+            {
+                _block.x = 0;
+                _block.y += BlockH;
+                if (_block.y >= _extent.y)
+                {
+                    _done = true;
+                    return;
+                }
+            }
+        } while (_block.x + _in_block.x >= _extent.x || _block.y + _in_block.y >= _extent.y);
+    }
+
+    bool is_done() const { return _done; }
+    bool is_block_start() const { return _in_block.x == 0 && _in_block.y == 0; }
+    tg::ipos2 block_pos() const { return tg::ipos2(_block.x, _block.y); }
+    tg::ipos2 pos() const { return tg::ipos2(_block.x + _in_block.x, _block.y + _in_block.y); }
+    int index_in_block() const { return _in_block.y * BlockW + _in_block.x; }
+
+private:
+    tg::ivec2 _extent;
+    tg::ivec2 _block = {0, 0};
+    tg::ivec2 _in_block = {0, 0};
+    bool _done;
+};
+
+/// enumerates all positions of a block image in memory order
+template <class StorageViewT>
+struct block_pos_iterator
+{
+    block_pos_iterator(tg::ivec2 /* stride */, tg::ivec2 extent) : _cursor(extent) {}
+
+    tg::ipos2 operator*() const { return _cursor.pos(); }
+    void operator++() { ++_cursor; }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    block_cursor<StorageViewT::block_width, StorageViewT::block_height> _cursor;
+};
+
+/// visits all (decoded) pixels and their positions of a block image in memory order
+/// each block is decoded once when it is entered
+template <class StorageViewT>
+struct block_entry_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_access_t = typename StorageViewT::pixel_access_t;
+    static constexpr int block_width = StorageViewT::block_width;
+    static constexpr int block_height = StorageViewT::block_height;
+
+    block_entry_iterator(data_ptr_t data, tg::ivec2 stride, tg::ivec2 extent) : _data(data), _stride(stride), _cursor(extent)
+    {
+        if (!_cursor.is_done())
+            decode_block();
+    }
+
+    pixel_entry<2, pixel_access_t> operator*() const { return {_cursor.pos(), pixel()}; }
+    void operator++()
+    {
+        ++_cursor;
+        if (!_cursor.is_done() && _cursor.is_block_start())
+            decode_block();
+    }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+protected:
+    pixel_access_t pixel() const
+    {
+        auto const& c = _decoded[_cursor.index_in_block()];
+        if constexpr (std::is_same_v<pixel_access_t, tg::color4>)
+            return c;
+        else
+        {
+            pixel_access_t r;
+            default_converter{}(r, c);
+            return r;
+        }
     }
-    void operator++() { ++_pos_it; }
-    bool operator!=(cc::sentinel) const { return _pos_it != cc::sentinel{}; }
 
 private:
-    strided_linear_pos_iterator<D> _pos_it;
+    void decode_block() { StorageViewT::block_at(_data, _cursor.block_pos(), _stride).decode(_decoded); }
+
     data_ptr_t _data;
-    tg::vec<D, int> _byte_stride;
+    tg::ivec2 _stride;
+    block_cursor<block_width, block_height> _cursor;
+    tg::color4 _decoded[block_width * block_height];
+};
+
+/// same as block_entry_iterator but only provides the (decoded) pixel values
+template <class StorageViewT>
+struct block_pixel_iterator : block_entry_iterator<StorageViewT>
+{
+    using block_entry_iterator<StorageViewT>::block_entry_iterator;
+
+    typename StorageViewT::pixel_access_t operator*() const { return this->pixel(); }
+};
+
+/// walks a tiled layout row by row in memory order (tile by tile, rows inside a tile)
+/// a row is the part of a tile row inside the extent, padding rows of partial tiles are skipped
+/// if merge_tiles is true, tiles that are fully inside the extent are reported as a single row
+template <int D, class StorageViewT>
+struct tiled_cursor
+{
+    static constexpr auto const& tile_sizes = StorageViewT::tile_sizes;
+
+    tiled_cursor(tg::vec<D, int> stride, tg::vec<D, int> extent, bool merge_tiles) : _stride(stride), _extent(extent), _merge_tiles(merge_tiles)
+    {
+        _done = detail::is_any_zero(extent);
+        if (!_done)
+            update_row();
+    }
+
+    void operator++()
+    {
+        if (!_is_merged)
+            for (auto d = 1; d < D; ++d)
+            {
+                if (++_local[d] < tile_extent(d))
+                {
+                    update_row();
+                    return;
+                }
+                _local[d] = 0;
+            }
+
+        for (auto d = 0; d < D; ++d)
+        {
+            _tile[d] += tile_sizes[d];
+            if (_tile[d] < _extent[d])
+            {
+                update_row();
+                return;
+            }
+            _tile[d] = 0;
+        }
+        _done = true;
+    }
+
+    bool is_done() const { return _done; }
+    tg::pos<D, int> row_pos() const { return _tile + tg::vec<D, int>(_local); }
+    int row_size() const { return _row_size; }
+    int64_t row_offset() const { return _row_offset; }
+
+private:
+    int tile_extent(int d) const { return _extent[d] - _tile[d] < tile_sizes[d] ? _extent[d] - _tile[d] : tile_sizes[d]; }
+
+    void update_row()
+    {
+        _row_offset = 0;
+        int64_t local = 0;
+        for (auto d = D - 1; d >= 0; --d)
+        {
+            _row_offset += int64_t(_tile[d] >> StorageViewT::tile_shifts[d]) * _stride[d];
+            local = (local << StorageViewT::tile_shifts[d]) + _local[d];
+        }
+        _row_offset += local * int64_t(sizeof(typename StorageViewT::pixel_t));
+
+        _row_size = tile_extent(0);
+        _is_merged = false;
+        if (_merge_tiles)
+        {
+            auto tile_pixels = 1;
+            auto is_full = true;
+            for (auto d = 0; d < D; ++d)
+            {
+                is_full = is_full && _local[d] == 0 && tile_extent(d) == tile_sizes[d];
+                tile_pixels *= tile_sizes[d];
+            }
+            if (is_full)
+            {
+                _row_size = tile_pixels;
+                _is_merged = true;
+            }
+        }
+    }
+
+    tg::vec<D, int> _stride;
+    tg::vec<D, int> _extent;
+    tg::pos<D, int> _tile;
+    tg::pos<D, int> _local;
+    int64_t _row_offset = 0;
+    int _row_size = 0;
+    bool _merge_tiles;
+    bool _is_merged = false;
+    bool _done;
+};
+
+/// enumerates all positions of a tiled image in memory order
+template <int D, class StorageViewT>
+struct tiled_pos_iterator
+{
+    tiled_pos_iterator(tg::vec<D, int> stride, tg::vec<D, int> extent) : _cursor(stride, extent, false) {}
+
+    tg::pos<D, int> operator*() const
+    {
+        auto p = _cursor.row_pos();
+        p.x += _i;
+        return p;
+    }
+    void operator++()
+    {
+        if (++_i < _cursor.row_size())
+            return;
+        _i = 0;
+        ++_cursor;
+    }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    tiled_cursor<D, StorageViewT> _cursor;
+    int _i = 0;
+};
+
+/// visits all rows of a tiled image in memory order
+/// each row is a contiguous pixel_run along x that does not cross tile boundaries
+template <int D, class StorageViewT>
+struct tiled_row_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
+
+    tiled_row_iterator(data_ptr_t data, tg::vec<D, int> stride, tg::vec<D, int> extent, bool merge_tiles = false)
+      : _data(data), _cursor(stride, extent, merge_tiles)
+    {
+        update_run();
+    }
+
+    pixel_run<D, pixel_t> const& operator*() const { return _run; }
+    void operator++()
+    {
+        ++_cursor;
+        update_run();
+    }
+    bool operator!=(cc::sentinel) const { return !_cursor.is_done(); }
+
+private:
+    void update_run()
+    {
+        if (_cursor.is_done())
+            return;
+        _run.data = _data + _cursor.row_offset();
+        _run.pos = _cursor.row_pos();
+        _run.size = _cursor.row_size();
+        _run.byte_stride = int(sizeof(pixel_t));
+    }
+
+    data_ptr_t _data;
+    tiled_cursor<D, StorageViewT> _cursor;
+    pixel_run<D, pixel_t> _run;
+};
+
+/// visits all pixels of a tiled image in memory order
+template <int D, class StorageViewT>
+struct tiled_pixel_iterator
+{
+    using data_ptr_t = typename StorageViewT::data_ptr_t;
+    using pixel_t = typename StorageViewT::pixel_t;
+
+    tiled_pixel_iterator(data_ptr_t data, tg::vec<D, int> stride, tg::vec<D, int> extent) : _rows(data, stride, extent) {}
+
+    typename StorageViewT::pixel_access_t operator*() const { return (*_rows)[_i]; }
+    void operator++()
+    {
+        if (++_i < (*_rows).size)
+            return;
+        _i = 0;
+        ++_rows;
+    }
+    bool operator!=(cc::sentinel s) const { return _rows != s; }
+
+protected:
+    tiled_row_iterator<D, StorageViewT> _rows;
+    int _i = 0;
+};
+
+/// same as tiled_pixel_iterator but additionally provides the pixel position
+template <int D, class StorageViewT>
+struct tiled_entry_iterator : tiled_pixel_iterator<D, StorageViewT>
+{
+    using tiled_pixel_iterator<D, StorageViewT>::tiled_pixel_iterator;
+
+    pixel_entry<D, typename StorageViewT::pixel_access_t> operator*() const
+    {
+        auto const& r = *this->_rows;
+        return {r.pos_at(this->_i), r[this->_i]};
+    }
 };
 }
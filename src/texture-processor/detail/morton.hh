@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__BMI2__)
+#define TP_HAS_BMI2 1
+#include <immintrin.h>
+#else
+#define TP_HAS_BMI2 0
+#endif
+
+// Morton (Z-order) index computation for 2D images
+//
+// to support non-square and non-power-of-two images, both extents are rounded up to the next power of two
+// the lower k bits of both coordinates are interleaved (k = log2 of the smaller padded extent)
+// and the remaining high bits of the larger dimension are appended on top
+// i.e. a 1024 x 256 image is stored as four 256 x 256 Z-order blocks next to each other
+//
+// the index is linear w.r.t. bitwise disjoint coordinates:
+//   morton(a | b) == morton(a) | morton(b)
+// thus, subviews that are aligned to a power of two larger than their extent are simple offsets
+namespace tp::detail
+{
+struct morton_tables
+{
+    uint16_t spread[256] = {};  // 8 bit -> 16 bit, bits spread to even positions
+    uint8_t compact[256] = {}; // even bits of a byte -> 4 bit
+
+    constexpr morton_tables()
+    {
+        for (auto i = 0; i < 256; ++i)
+        {
+            uint16_t s = 0;
+            uint8_t c = 0;
+            for (auto b = 0; b < 8; ++b)
+            {
+                if (i & (1 << b))
+                    s |= uint16_t(1u << (2 * b));
+                if (b % 2 == 0 && (i & (1 << b)))
+                    c |= uint8_t(1u << (b / 2));
+            }
+            spread[i] = s;
+            compact[i] = c;
+        }
+    }
+};
+
+inline constexpr morton_tables morton_lut = {};
+
+/// spreads the bits of v to the even bit positions of the result
+inline uint64_t morton_spread(uint32_t v)
+{
+#if TP_HAS_BMI2
+    return _pdep_u64(v, 0x5555555555555555ull);
+#else
+    return uint64_t(morton_lut.spread[v & 0xFF])               //
+           | uint64_t(morton_lut.spread[(v >> 8) & 0xFF]) << 16  //
+           | uint64_t(morton_lut.spread[(v >> 16) & 0xFF]) << 32 //
+           | uint64_t(morton_lut.spread[(v >> 24) & 0xFF]) << 48;
+#endif
+}
+
+/// gathers the even bits of v (inverse of morton_spread)
+inline uint32_t morton_compact(uint64_t v)
+{
+#if TP_HAS_BMI2
+    return uint32_t(_pext_u64(v, 0x5555555555555555ull));
+#else
+    uint32_t r = 0;
+    for (auto i = 0; i < 8; ++i)
+        r |= uint32_t(morton_lut.compact[(v >> (8 * i)) & 0xFF]) << (4 * i);
+    return r;
+#endif
+}
+
+/// returns the smallest k with (1 << k) >= v (for v >= 1)
+constexpr int ceil_log2(uint32_t v)
+{
+    auto k = 0;
+    while ((uint64_t(1) << k) < v)
+        ++k;
+    return k;
+}
+
+/// number of interleaved bits per coordinate for a given image extent
+constexpr int morton_interleaved_bits(int width, int height)
+{
+    auto const kx = ceil_log2(uint32_t(width > 0 ? width : 1));
+    auto const ky = ceil_log2(uint32_t(height > 0 ? height : 1));
+    return kx < ky ? kx : ky;
+}
+
+/// number of elements that need to be stored for a Z-order image (both extents padded to powers of two)
+constexpr uint64_t morton_storage_size(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return 0;
+    return uint64_t(1) << (ceil_log2(uint32_t(width)) + ceil_log2(uint32_t(height)));
+}
+
+/// Z-order index of pixel (x, y) where k is the number of interleaved bits
+inline uint64_t morton_index(int x, int y, int k)
+{
+    auto const m = uint32_t((uint64_t(1) << k) - 1);
+    auto const lo = morton_spread(uint32_t(x) & m) | (morton_spread(uint32_t(y) & m) << 1);
+    auto const hi = uint64_t((uint32_t(x) >> k) | (uint32_t(y) >> k));
+    return lo | (hi << (2 * k));
+}
+
+/// inverse of morton_index
+/// high_is_x determines to which coordinate the bits above the interleaved part belong
+inline void morton_decode(uint64_t idx, int k, bool high_is_x, int& x, int& y)
+{
+    auto const lo = 2 * k >= 64 ? idx : idx & ((uint64_t(1) << (2 * k)) - 1);
+    auto const hi = 2 * k >= 64 ? 0 : uint32_t(idx >> (2 * k));
+    x = int(morton_compact(lo));
+    y = int(morton_compact(lo >> 1));
+    if (high_is_x)
+        x |= int(hi << k);
+    else
+        y |= int(hi << k);
+}
+
+/// returns true if a subview at start with the given extent is a valid Z-order subview
+/// (i.e. start is aligned to a power of two that is at least as large as the extent)
+inline bool is_morton_aligned(int start_x, int start_y, int width, int height)
+{
+    auto const s = uint32_t(1) << ceil_log2(uint32_t(width > height ? width : height));
+    return (uint32_t(start_x) & (s - 1)) == 0 && (uint32_t(start_y) & (s - 1)) == 0;
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <texture-processor/detail/transpose.hh> // TP_HAS_SSE2, transpose_4x4_32bit
+
+// conversion kernels between interleaved (AoS) pixels and planar (SoA) images
+// the inner loops work on runs of pixels (e.g. rows), where consecutive pixels are *_step bytes apart
+// channel c of a planar pixel lies c * plane_bytes after channel 0
+// densely packed runs of 2 or 4 channels with 32 bit scalars use SSE2 shuffles/transposes, everything else uses scalar loops
+namespace tp::detail
+{
+/// splits a run of count interleaved pixels (N channels of ScalarT) into N planes
+template <int N, class ScalarT>
+void deinterleave_run(std::byte const* src, int64_t src_step, std::byte* dst, int64_t dst_step, int64_t plane_bytes, int count)
+{
+    constexpr int64_t scalar_size = sizeof(ScalarT);
+    if (src_step == N * scalar_size && dst_step == scalar_size)
+    {
+        auto i = 0;
+#if TP_HAS_SSE2
+        if constexpr (scalar_size == 4 && N == 4)
+        {
+            // 4 pixels are 4 registers, the transposed registers are 4 values of each plane
+            for (; i + 4 <= count; i += 4)
+                transpose_4x4_32bit(src + i * 16, 16, dst + i * 4, plane_bytes);
+        }
+        else if constexpr (scalar_size == 4 && N == 2)
+        {
+            for (; i + 4 <= count; i += 4)
+            {
+                auto const a = _mm_loadu_ps(reinterpret_cast<float const*>(src + i * 8));
+                auto const b = _mm_loadu_ps(reinterpret_cast<float const*>(src + i * 8 + 16));
+                _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 4), _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 4 + plane_bytes), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+        }
+#endif
+        // plane by plane, so that the writes are contiguous
+        auto const s = reinterpret_cast<ScalarT const*>(src);
+        for (auto c = 0; c < N; ++c)
+        {
+            auto const d = reinterpret_cast<ScalarT*>(dst + c * plane_bytes);
+            for (auto k = i; k < count; ++k)
+                d[k] = s[k * N + c];
+        }
+        return;
+    }
+
+    for (auto i = 0; i < count; ++i, src += src_step, dst += dst_step)
+        for (auto c = 0; c < N; ++c)
+            std::memcpy(dst + c * plane_bytes, src + c * scalar_size, scalar_size);
+}
+
+/// merges a run of count pixels from N planes into interleaved pixels (N channels of ScalarT)
+template <int N, class ScalarT>
+void interleave_run(std::byte const* src, int64_t src_step, int64_t plane_bytes, std::byte* dst, int64_t dst_step, int count)
+{
+    constexpr int64_t scalar_size = sizeof(ScalarT);
+    if (src_step == scalar_size && dst_step == N * scalar_size)
+    {
+        auto i = 0;
+#if TP_HAS_SSE2
+        if constexpr (scalar_size == 4 && N == 4)
+        {
+            // inverse of the deinterleave transpose
+            for (; i + 4 <= count; i += 4)
+                transpose_4x4_32bit(src + i * 4, plane_bytes, dst + i * 16, 16);
+        }
+        else if constexpr (scalar_size == 4 && N == 2)
+        {
+            for (; i + 4 <= count; i += 4)
+            {
+                auto const x = _mm_loadu_ps(reinterpret_cast<float const*>(src + i * 4));
+                auto const y = _mm_loadu_ps(reinterpret_cast<float const*>(src + i * 4 + plane_bytes));
+                _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 8), _mm_unpacklo_ps(x, y));
+                _mm_storeu_ps(reinterpret_cast<float*>(dst + i * 8 + 16), _mm_unpackhi_ps(x, y));
+            }
+        }
+#endif
+        auto const d = reinterpret_cast<ScalarT*>(dst);
+        for (auto k = i; k < count; ++k)
+            for (auto c = 0; c < N; ++c)
+                d[k * N + c] = *reinterpret_cast<ScalarT const*>(src + c * plane_bytes + k * scalar_size);
+        return;
+    }
+
+    for (auto i = 0; i < count; ++i, src += src_step, dst += dst_step)
+        for (auto c = 0; c < N; ++c)
+            std::memcpy(dst + c * scalar_size, src + c * plane_bytes, scalar_size);
+}
+}
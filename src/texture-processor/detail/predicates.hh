@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <typed-geometry/tg-lean.hh>
@@ -56,6 +57,61 @@ constexpr bool is_natural_stride(tg::vec<D, int> const& stride, int pixel_size,
     return stride == natural_stride_for(pixel_size, extent);
 }
 
+/// returns true if any dimension with more than one pixel has a zero stride (i.e. pixels are repeated)
+/// NOTE: empty views are never broadcasting (their natural stride can be zero, e.g. for a width of 0)
+template <int D>
+constexpr bool is_broadcasting(tg::vec<D, int> const& stride, tg::vec<D, int> const& extent)
+{
+    if (is_any_zero(extent))
+        return false;
+    for (auto i = 0; i < D; ++i)
+        if (stride[i] == 0 && extent[i] > 1)
+            return true;
+    return false;
+}
+
+/// computes the smallest and largest byte offset of any pixel in a strided view (relative to its data ptr)
+/// NOTE: extent must not be empty
+template <int D>
+constexpr void strided_offset_range(tg::vec<D, int> const& stride, tg::vec<D, int> const& extent, int64_t& min_offset, int64_t& max_offset)
+{
+    min_offset = 0;
+    max_offset = 0;
+    for (auto i = 0; i < D; ++i)
+    {
+        auto o = int64_t(stride[i]) * (extent[i] - 1);
+        if (o < 0)
+            min_offset += o;
+        else
+            max_offset += o;
+    }
+}
+
+/// returns true if the memory regions spanned by two strided views intersect
+/// NOTE: this is conservative, i.e. interleaved views might be reported as overlapping
+template <int D>
+bool is_overlapping(std::byte const* data_a,
+                    tg::vec<D, int> const& stride_a,
+                    int pixel_size_a,
+                    std::byte const* data_b,
+                    tg::vec<D, int> const& stride_b,
+                    int pixel_size_b,
+                    tg::vec<D, int> const& extent)
+{
+    if (is_any_zero(extent))
+        return false;
+
+    int64_t min_a, max_a, min_b, max_b;
+    strided_offset_range(stride_a, extent, min_a, max_a);
+    strided_offset_range(stride_b, extent, min_b, max_b);
+
+    auto begin_a = data_a + min_a;
+    auto end_a = data_a + max_a + pixel_size_a;
+    auto begin_b = data_b + min_b;
+    auto end_b = data_b + max_b + pixel_size_b;
+    return begin_a < end_b && begin_b < end_a;
+}
+
 template <int D>
 struct skip_index;
 template <>
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstdint>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/detail/iterator.hh>
+#include <texture-processor/detail/predicates.hh>
+#include <texture-processor/execution.hh>
+#include <texture-processor/extents.hh>
+#include <texture-processor/fwd.hh>
+#include <texture-processor/image_metadata.hh>
+
+// splitting of images into tiles for parallel processing
+namespace tp::detail
+{
+/// default number of pixels per tile (roughly a quarter of a typical L2)
+template <class PixelT>
+constexpr int64_t default_grain_size()
+{
+    constexpr int64_t bytes = 256 * 1024;
+    return sizeof(PixelT) >= bytes ? 1 : bytes / int64_t(sizeof(PixelT));
+}
+
+/// computes a tile extent with approximately grain_size pixels
+/// dimensions are cut from the outermost (largest stride) inwards, so tiles are mostly contiguous in memory
+template <int D>
+tg::vec<D, int> compute_tile_extent(tg::vec<D, int> const& byte_stride, tg::vec<D, int> const& extent, int64_t grain_size)
+{
+    uint8_t order[D];
+    compute_stride_order(byte_stride, order);
+
+    auto tile = extent;
+    for (auto i = D - 1; i >= 0; --i)
+    {
+        int64_t inner = 1;
+        for (auto j = 0; j < i; ++j)
+            inner *= extent[order[j]];
+
+        auto& t = tile[order[i]];
+        if (inner * t <= grain_size)
+            break;
+
+        if (inner > grain_size)
+            t = 1; // still too large, continue with next inner dimension
+        else
+        {
+            t = int(grain_size / inner);
+            break;
+        }
+    }
+    return tile;
+}
+
+/// returns a view onto the same pixels that supports arbitrary subviews
+/// (cubemaps are reinterpreted as 2D arrays with 6 layers, as their subviews are not cubes anymore)
+template <class ViewT>
+auto as_tileable(ViewT const& view)
+{
+    if constexpr (std::is_same_v<typename ViewT::extent_t, extent_cube>)
+        return image_view<base_traits::linear2D_array<typename ViewT::pixel_t>>::from_data(
+            view.data_ptr(), extent2_array::from_ivec(view.extent().to_ivec()), view.byte_stride());
+    else
+        return view;
+}
+
+/// computes a square power-of-two tile extent with at most grain_size pixels (at least 1)
+/// such tiles are valid subviews of Z-order images
+template <int D>
+tg::vec<D, int> compute_aligned_tile_extent(int64_t grain_size)
+{
+    auto side = 1;
+    while (int64_t(side) * side * 4 <= grain_size)
+        side *= 2;
+
+    tg::vec<D, int> tile;
+    for (auto d = 0; d < D; ++d)
+        tile[d] = d < 2 ? side : 1;
+    return tile;
+}
+
+/// subviews of tiled views must start at tile boundaries
+/// returns the largest tile size of the view (1 if not tiled), multiples of it are valid subview starts as tile sizes are powers of two
+template <class ViewT>
+constexpr int tile_alignment_of()
+{
+    if constexpr (ViewT::traits::layout_type == layout_type::tiled)
+        return ViewT::storage_view_t::max_tile_size;
+    else
+        return 1;
+}
+
+/// calls f(ipos_t start, tile) for each tile of the view, distributed over the policy's thread pool
+/// tile indices are enumerated in memory order, so neighboring tasks touch neighboring memory
+/// if aligned_tiles is true, tiles are power-of-two squares (required if a Z-order view is involved)
+/// tile extents are multiples of alignment (e.g. when the tiles are used as subviews of a tiled view)
+/// NOTE: tiles are subviews of as_tileable(view)
+template <class ViewT, class F>
+void for_each_tile(parallel_policy const& policy, ViewT const& view, F&& f, bool aligned_tiles = false, int alignment = 1)
+{
+    if constexpr (!std::is_same_v<decltype(as_tileable(view)), ViewT>)
+    {
+        for_each_tile(policy, as_tileable(view), f, aligned_tiles, alignment);
+        return;
+    }
+
+    constexpr auto D = ViewT::dimensions;
+    using ipos_t = typename ViewT::ipos_t;
+    using ivec_t = typename ViewT::ivec_t;
+    using extent_t = typename ViewT::subview_t::extent_t; // tiles of fixed-size views are dynamically sized
+
+    auto const extent = view.extent().to_ivec();
+    if (detail::is_any_zero(extent))
+        return;
+
+    auto const grain_size = policy.grain_size > 0 ? policy.grain_size : default_grain_size<typename ViewT::pixel_t>();
+    aligned_tiles = aligned_tiles || ViewT::traits::layout_type == layout_type::z_order;
+    auto tile = aligned_tiles ? compute_aligned_tile_extent<D>(grain_size) : compute_tile_extent(view.byte_stride(), extent, grain_size);
+
+    // tiles of block-based views must start at block boundaries
+    if constexpr (ViewT::traits::is_block_based)
+        for (auto d = 0; d < D; ++d)
+            tile[d] = (tile[d] + ViewT::traits::block_sizes[d] - 1) / ViewT::traits::block_sizes[d] * ViewT::traits::block_sizes[d];
+
+    // tiles of tiled views must start at tile boundaries
+    if constexpr (ViewT::traits::layout_type == layout_type::tiled)
+        for (auto d = 0; d < D; ++d)
+            tile[d] = (tile[d] + ViewT::storage_view_t::tile_sizes[d] - 1) / ViewT::storage_view_t::tile_sizes[d] * ViewT::storage_view_t::tile_sizes[d];
+    if (alignment > 1)
+        for (auto d = 0; d < D; ++d)
+            tile[d] = (tile[d] + alignment - 1) / alignment * alignment;
+
+    uint8_t order[D];
+    compute_stride_order(view.byte_stride(), order);
+
+    ivec_t tile_count;
+    int64_t total = 1;
+    for (auto d = 0; d < D; ++d)
+    {
+        tile_count[d] = (extent[d] + tile[d] - 1) / tile[d];
+        total *= tile_count[d];
+    }
+
+    policy.get_pool().parallel_for(total, [&](int64_t idx) {
+        ipos_t start;
+        ivec_t size;
+        for (auto i = 0; i < D; ++i)
+        {
+            auto const d = order[i];
+            start[d] = int(idx % tile_count[d]) * tile[d];
+            size[d] = extent[d] - start[d] < tile[d] ? extent[d] - start[d] : tile[d];
+            idx /= tile_count[d];
+        }
+        f(start, view.subview(start, extent_t::from_ivec(size)));
+    });
+}
+}
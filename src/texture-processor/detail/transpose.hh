@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TP_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define TP_HAS_SSE2 0
+#endif
+
+// blocked copy for views whose innermost dimensions disagree (e.g. copying a swapped_xy() view)
+// a naive row-wise copy reads contiguously but writes one pixel per cache line (and often per TLB page)
+// here, the copy is done in small square tiles that fit into L1 so that both sides are accessed line by line
+namespace tp::detail
+{
+/// tile size (in pixels per side) for blocked transposes
+template <class PixelT>
+constexpr int transpose_tile_size()
+{
+    // ~4 KiB per tile side-by-side in L1
+    if constexpr (sizeof(PixelT) <= 4)
+        return 32;
+    else if constexpr (sizeof(PixelT) <= 16)
+        return 16;
+    else
+        return 8;
+}
+
+/// copies a single tile pixel by pixel
+/// a is the dimension that is contiguous in src, b the one contiguous in dst
+template <class PixelT>
+void transpose_tile_generic(std::byte const* src, int64_t src_stride_a, int64_t src_stride_b, std::byte* dst, int64_t dst_stride_a, int64_t dst_stride_b, int size_a, int size_b)
+{
+    for (auto ia = 0; ia < size_a; ++ia)
+    {
+        auto s = src + ia * src_stride_a;
+        auto d = dst + ia * dst_stride_a;
+        for (auto ib = 0; ib < size_b; ++ib, s += src_stride_b, d += dst_stride_b)
+            std::memcpy(d, s, sizeof(PixelT));
+    }
+}
+
+#if TP_HAS_SSE2
+/// 4x4 in-register transpose of 32 bit pixels
+/// src rows (along a) and dst rows (along b) are both contiguous
+inline void transpose_4x4_32bit(std::byte const* src, int64_t src_stride_b, std::byte* dst, int64_t dst_stride_a)
+{
+    auto r0 = _mm_loadu_ps(reinterpret_cast<float const*>(src + 0 * src_stride_b));
+    auto r1 = _mm_loadu_ps(reinterpret_cast<float const*>(src + 1 * src_stride_b));
+    auto r2 = _mm_loadu_ps(reinterpret_cast<float const*>(src + 2 * src_stride_b));
+    auto r3 = _mm_loadu_ps(reinterpret_cast<float const*>(src + 3 * src_stride_b));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(reinterpret_cast<float*>(dst + 0 * dst_stride_a), r0);
+    _mm_storeu_ps(reinterpret_cast<float*>(dst + 1 * dst_stride_a), r1);
+    _mm_storeu_ps(reinterpret_cast<float*>(dst + 2 * dst_stride_a), r2);
+    _mm_storeu_ps(reinterpret_cast<float*>(dst + 3 * dst_stride_a), r3);
+}
+
+/// 4x4 transpose of 128 bit pixels (each pixel is exactly one register)
+inline void transpose_4x4_128bit(std::byte const* src, int64_t src_stride_b, std::byte* dst, int64_t dst_stride_a)
+{
+    __m128i r[4][4];
+    for (auto ib = 0; ib < 4; ++ib)
+        for (auto ia = 0; ia < 4; ++ia)
+            r[ib][ia] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + ib * src_stride_b + ia * 16));
+    for (auto ia = 0; ia < 4; ++ia)
+        for (auto ib = 0; ib < 4; ++ib)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ia * dst_stride_a + ib * 16), r[ib][ia]);
+}
+#endif
+
+/// copies a single tile, using in-register 4x4 transposes for 4 and 16 byte pixels if both sides are densely packed
+template <class PixelT>
+void transpose_tile(std::byte const* src, int64_t src_stride_a, int64_t src_stride_b, std::byte* dst, int64_t dst_stride_a, int64_t dst_stride_b, int size_a, int size_b)
+{
+#if TP_HAS_SSE2
+    if constexpr (sizeof(PixelT) == 4 || sizeof(PixelT) == 16)
+    {
+        if (src_stride_a == int64_t(sizeof(PixelT)) && dst_stride_b == int64_t(sizeof(PixelT)))
+        {
+            auto const size_a4 = size_a & ~3;
+            auto const size_b4 = size_b & ~3;
+            for (auto ib = 0; ib < size_b4; ib += 4)
+                for (auto ia = 0; ia < size_a4; ia += 4)
+                {
+                    auto s = src + ia * src_stride_a + ib * src_stride_b;
+                    auto d = dst + ia * dst_stride_a + ib * dst_stride_b;
+                    if constexpr (sizeof(PixelT) == 4)
+                        transpose_4x4_32bit(s, src_stride_b, d, dst_stride_a);
+                    else
+                        transpose_4x4_128bit(s, src_stride_b, d, dst_stride_a);
+                }
+
+            // remainders
+            if (size_a4 < size_a)
+                transpose_tile_generic<PixelT>(src + size_a4 * src_stride_a, src_stride_a, src_stride_b, dst + size_a4 * dst_stride_a, dst_stride_a,
+                                               dst_stride_b, size_a - size_a4, size_b);
+            if (size_b4 < size_b)
+                transpose_tile_generic<PixelT>(src + size_b4 * src_stride_b, src_stride_a, src_stride_b, dst + size_b4 * dst_stride_b, dst_stride_a,
+                                               dst_stride_b, size_a4, size_b - size_b4);
+            return;
+        }
+    }
+#endif
+
+    transpose_tile_generic<PixelT>(src, src_stride_a, src_stride_b, dst, dst_stride_a, dst_stride_b, size_a, size_b);
+}
+
+/// copies a 2D region of pixels tile by tile
+/// a is the dimension where src has the smaller stride, b the one where dst has the smaller stride
+template <class PixelT>
+void blocked_transpose_copy(std::byte const* src, int64_t src_stride_a, int64_t src_stride_b, std::byte* dst, int64_t dst_stride_a, int64_t dst_stride_b, int size_a, int size_b)
+{
+    constexpr auto tile = transpose_tile_size<PixelT>();
+    for (auto b0 = 0; b0 < size_b; b0 += tile)
+    {
+        auto const tb = size_b - b0 < tile ? size_b - b0 : tile;
+        for (auto a0 = 0; a0 < size_a; a0 += tile)
+        {
+            auto const ta = size_a - a0 < tile ? size_a - a0 : tile;
+            transpose_tile<PixelT>(src + a0 * src_stride_a + b0 * src_stride_b, src_stride_a, src_stride_b, //
+                                   dst + a0 * dst_stride_a + b0 * dst_stride_b, dst_stride_a, dst_stride_b, ta, tb);
+        }
+    }
+}
+}
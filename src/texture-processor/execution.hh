@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <texture-processor/thread_pool.hh>
+
+// execution policies for image algorithms
+// usage:
+//    img.fill(tp::par, tg::color3::black);
+//    src.copy_to(tp::par.with_grain_size(64 * 64), dst);
+//    img.for_each(tp::par.on(my_pool), [](tg::ipos2 p, float& v) { ... });
+namespace tp
+{
+/// executes an algorithm on the calling thread (this is the default)
+struct sequenced_policy
+{
+};
+
+/// splits the image into tiles (via subview) and processes them on a thread pool
+/// NOTE: for pure per-pixel kernels, the result is bit-identical to the sequential version
+struct parallel_policy
+{
+    /// approximate number of pixels per tile (0 means a cache-sized default)
+    int64_t grain_size = 0;
+
+    /// pool to run on (nullptr means thread_pool::global())
+    thread_pool* pool = nullptr;
+
+    [[nodiscard]] constexpr parallel_policy with_grain_size(int64_t pixels) const
+    {
+        auto p = *this;
+        p.grain_size = pixels;
+        return p;
+    }
+    [[nodiscard]] constexpr parallel_policy on(thread_pool& p) const
+    {
+        auto r = *this;
+        r.pool = &p;
+        return r;
+    }
+
+    thread_pool& get_pool() const { return pool ? *pool : thread_pool::global(); }
+};
+
+inline constexpr sequenced_policy seq = {};
+inline constexpr parallel_policy par = {};
+
+template <class T>
+static constexpr bool is_execution_policy = std::is_same_v<T, sequenced_policy> || std::is_same_v<T, parallel_policy>;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include <clean-core/assert.hh>
+#include <clean-core/move.hh>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/execution.hh>
+#include <texture-processor/image.hh>
+#include <texture-processor/image_view.hh>
+#include <texture-processor/pixel_traits.hh>
+#include <texture-processor/procedural.hh>
+
+/**
+ * Lazy component-wise arithmetic on images and views
+ *
+ * operators and functions on images build procedural views (see procedural.hh) instead of temporaries,
+ * so a whole formula is evaluated in a single pass (one read per input pixel, one write per output pixel):
+ *
+ *    auto composite = a * b + c * 0.5f;       // nothing is computed yet
+ *    composite.copy_to(tp::par, target);      // evaluated tile by tile
+ *    auto img = tp::evaluate(tp::mix(a, b, mask));
+ *
+ * operands are images, views (including other expressions), pixel values or scalars
+ * all image operands must have the same extent, the result has the pixel type of the first image operand
+ * operations are applied per channel (scalars and scalar images are used for all channels)
+ *
+ * NOTE: images are captured as views, i.e. they must outlive the expression
+ */
+
+namespace tp
+{
+namespace detail
+{
+template <class T>
+constexpr bool is_expression_image = is_image_or_view<T>;
+template <class... Ts>
+constexpr bool has_image_operand = (is_expression_image<Ts> || ...);
+
+/// images are captured as (non-owning) views, everything else by value
+template <class T>
+auto as_operand(T const& v)
+{
+    if constexpr (is_image<T>)
+        return static_cast<image_view<typename T::traits::base_t> const&>(v);
+    else
+        return v;
+}
+
+/// the pixel of an operand at p (constants are the same everywhere)
+template <class T, int D>
+auto operand_value(T const& v, tg::pos<D, int> const& p)
+{
+    if constexpr (is_image_view<T>)
+        return std::remove_const_t<typename T::pixel_t>(v.at_unchecked(p));
+    else
+        return v;
+}
+
+template <class T>
+auto channel_of(T const& v, int c)
+{
+    if constexpr (std::is_arithmetic_v<T>)
+        return v;
+    else
+        return v[c];
+}
+
+/// applies f per channel, the result has pixel type R
+template <class R, class F, class... Ts>
+R componentwise(F const& f, Ts const&... vs)
+{
+    if constexpr (std::is_arithmetic_v<R>)
+        return R(f(vs...));
+    else
+    {
+        using scalar_t = typename pixel_traits<R>::scalar_t;
+        R r;
+        for (auto c = 0; c < pixel_traits<R>::channels; ++c)
+            r[c] = scalar_t(f(channel_of(vs, c)...));
+        return r;
+    }
+}
+
+template <class T, class... Ts>
+auto const& first_image_operand(T const& v, Ts const&... vs)
+{
+    if constexpr (is_image_view<T>)
+        return v;
+    else
+        return first_image_operand(vs...);
+}
+
+template <class T, class ExtentT>
+void check_operand_extent(T const& v, ExtentT const& extent)
+{
+    if constexpr (is_image_view<T>)
+        CC_ASSERT(v.extent().to_ivec() == extent.to_ivec() && "all image operands must have the same extent");
+}
+
+/// lazy view of f(operand(p)...) where operands are already captured via as_operand
+template <class F, class... Ts>
+auto make_expression(F f, Ts... operands)
+{
+    auto const& first = first_image_operand(operands...);
+    using ipos_t = typename std::decay_t<decltype(first)>::ipos_t;
+    auto const extent = first.extent();
+    (check_operand_extent(operands, extent), ...);
+    return procedural_view(extent, [f = cc::move(f), operands...](ipos_t const& p) { return f(operand_value(operands, p)...); });
+}
+
+/// lazy view of f applied per channel, with the pixel type of the first image operand
+template <class F, class... Ts>
+auto make_componentwise_expression(F f, Ts const&... operands)
+{
+    using result_t = std::remove_const_t<typename std::decay_t<decltype(first_image_operand(as_operand(operands)...))>::pixel_t>;
+    return make_expression([f = cc::move(f)](auto const&... vs) { return componentwise<result_t>(f, vs...); }, as_operand(operands)...);
+}
+}
+
+/// lazy view of f(a(p), b(p), ...) for all positions p, f receives whole pixels
+/// (non-image operands are passed as they are)
+template <class F, class... Ts, class = std::enable_if_t<detail::has_image_operand<Ts...>>>
+[[nodiscard]] auto zipped_view(F f, Ts const&... operands)
+{
+    return detail::make_expression(cc::move(f), detail::as_operand(operands)...);
+}
+
+/// evaluates a (lazy) view into a new image, e.g. tp::evaluate(a * b + c)
+template <class ExecutionPolicy, class ViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] auto evaluate(ExecutionPolicy const& policy, ViewT const& view) -> image_type_of<ViewT>
+{
+    static_assert(is_image_or_view<ViewT>);
+    auto res = image_type_of<ViewT>::uninitialized(view.extent());
+    view.copy_to(policy, res);
+    return res;
+}
+template <class ViewT>
+[[nodiscard]] auto evaluate(ViewT const& view) -> image_type_of<ViewT>
+{
+    return evaluate(seq, view);
+}
+
+//
+// component-wise operators
+//
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto operator+(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return x + y; }, a, b);
+}
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto operator-(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return x - y; }, a, b);
+}
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto operator*(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return x * y; }, a, b);
+}
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto operator/(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return x / y; }, a, b);
+}
+template <class A, class = std::enable_if_t<detail::has_image_operand<A>>>
+[[nodiscard]] auto operator-(A const& a)
+{
+    return detail::make_componentwise_expression([](auto x) { return -x; }, a);
+}
+
+//
+// component-wise functions
+//
+/// a + (b - a) * t, t can be a scalar, a pixel or a (scalar) image
+template <class A, class B, class T, class = std::enable_if_t<detail::has_image_operand<A, B, T>>>
+[[nodiscard]] auto mix(A const& a, B const& b, T const& t)
+{
+    return detail::make_componentwise_expression([](auto x, auto y, auto s) { return x + (y - x) * s; }, a, b, t);
+}
+template <class A, class L, class H, class = std::enable_if_t<detail::has_image_operand<A, L, H>>>
+[[nodiscard]] auto clamp(A const& a, L const& lo, H const& hi)
+{
+    return detail::make_componentwise_expression(
+        [](auto x, auto l, auto h) { return x < l ? decltype(x)(l) : h < x ? decltype(x)(h) : x; }, a, lo, hi);
+}
+template <class A, class E, class = std::enable_if_t<detail::has_image_operand<A, E>>>
+[[nodiscard]] auto pow(A const& a, E const& e)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return std::pow(x, y); }, a, e);
+}
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto min(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return y < x ? decltype(x)(y) : x; }, a, b);
+}
+template <class A, class B, class = std::enable_if_t<detail::has_image_operand<A, B>>>
+[[nodiscard]] auto max(A const& a, B const& b)
+{
+    return detail::make_componentwise_expression([](auto x, auto y) { return x < y ? decltype(x)(y) : x; }, a, b);
+}
+/// applies f to each channel of the operands, e.g. tp::componentwise([](float x) { return tg::sqrt(x); }, img)
+template <class F, class... Ts, class = std::enable_if_t<detail::has_image_operand<Ts...>>>
+[[nodiscard]] auto componentwise(F f, Ts const&... operands)
+{
+    return detail::make_componentwise_expression(cc::move(f), operands...);
+}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
 #include <clean-core/assert.hh>
 
@@ -135,4 +136,241 @@ constexpr void introspect(In&& inspect, extent_cube& v)
 {
     inspect(v.size, "size");
 }
+
+//
+// fixed extents (all dimensions are compile-time constants)
+// these are empty, i.e. views with fixed extents carry no extent state
+// from_ivec only accepts the fixed size
+//
+
+namespace detail
+{
+template <class ExtentT>
+struct is_fixed_extent_t : std::false_type
+{
+};
+}
+
+template <int W>
+struct fixed_extent1
+{
+    static_assert(W >= 0, "extent must be non-negative");
+    static constexpr int dimensions = 1;
+    static constexpr int width = W;
+
+    static constexpr tg::ivec1 to_ivec() { return {W}; }
+    static fixed_extent1 from_ivec(tg::ivec1 const& e)
+    {
+        CC_ASSERT(e.x == W && "extent does not match the fixed extent");
+        (void)e;
+        return {};
+    }
+    static constexpr uint64_t pixel_count() { return uint64_t(W); }
+
+    constexpr bool operator==(fixed_extent1 const&) const { return true; }
+    constexpr bool operator!=(fixed_extent1 const&) const { return false; }
+};
+
+template <int W, int H>
+struct fixed_extent2
+{
+    static_assert(W >= 0 && H >= 0, "extent must be non-negative");
+    static constexpr int dimensions = 2;
+    static constexpr int width = W;
+    static constexpr int height = H;
+
+    static constexpr tg::ivec2 to_ivec() { return {W, H}; }
+    static fixed_extent2 from_ivec(tg::ivec2 const& e)
+    {
+        CC_ASSERT(e.x == W && e.y == H && "extent does not match the fixed extent");
+        (void)e;
+        return {};
+    }
+    static constexpr uint64_t pixel_count() { return uint64_t(W) * uint64_t(H); }
+
+    constexpr bool operator==(fixed_extent2 const&) const { return true; }
+    constexpr bool operator!=(fixed_extent2 const&) const { return false; }
+};
+
+template <int W, int H, int D>
+struct fixed_extent3
+{
+    static_assert(W >= 0 && H >= 0 && D >= 0, "extent must be non-negative");
+    static constexpr int dimensions = 3;
+    static constexpr int width = W;
+    static constexpr int height = H;
+    static constexpr int depth = D;
+
+    static constexpr tg::ivec3 to_ivec() { return {W, H, D}; }
+    static fixed_extent3 from_ivec(tg::ivec3 const& e)
+    {
+        CC_ASSERT(e.x == W && e.y == H && e.z == D && "extent does not match the fixed extent");
+        (void)e;
+        return {};
+    }
+    static constexpr uint64_t pixel_count() { return uint64_t(W) * uint64_t(H) * uint64_t(D); }
+
+    constexpr bool operator==(fixed_extent3 const&) const { return true; }
+    constexpr bool operator!=(fixed_extent3 const&) const { return false; }
+};
+
+namespace detail
+{
+template <int W>
+struct is_fixed_extent_t<fixed_extent1<W>> : std::true_type
+{
+};
+template <int W, int H>
+struct is_fixed_extent_t<fixed_extent2<W, H>> : std::true_type
+{
+};
+template <int W, int H, int D>
+struct is_fixed_extent_t<fixed_extent3<W, H, D>> : std::true_type
+{
+};
+}
+
+template <class ExtentT>
+static constexpr bool is_fixed_extent = detail::is_fixed_extent_t<ExtentT>::value;
+
+//
+// power-of-two extents (each dimension is stored as its log2, -1 denotes an empty dimension)
+// sizes, pixel counts, and mip level extents are shifts
+// from_ivec only accepts powers of two (or 0)
+//
+
+namespace detail
+{
+constexpr int pow2_or_zero(int log2) { return log2 < 0 ? 0 : 1 << log2; }
+inline int log2_of_pow2(int v)
+{
+    CC_ASSERT(v >= 0 && (v & (v - 1)) == 0 && "extent must be a power of two (or 0)");
+    auto l = -1;
+    while (v > 0)
+    {
+        v >>= 1;
+        ++l;
+    }
+    return l;
+}
+constexpr int mip_log2(int log2, int level) { return log2 < 0 ? -1 : log2 > level ? log2 - level : 0; }
+
+template <class ExtentT>
+struct is_pow2_extent_t : std::false_type
+{
+};
+}
+
+struct pow2_extent1
+{
+    int log2_width = -1;
+
+    tg::ivec1 to_ivec() const { return {detail::pow2_or_zero(log2_width)}; }
+    static pow2_extent1 from_ivec(tg::ivec1 const& e) { return {detail::log2_of_pow2(e.x)}; }
+    uint64_t pixel_count() const { return log2_width < 0 ? 0 : uint64_t(1) << log2_width; }
+
+    /// extent of the given mip level (each dimension is halved down to 1)
+    pow2_extent1 mip_extent(int level) const { return {detail::mip_log2(log2_width, level)}; }
+    /// number of mip levels down to a single pixel
+    int mip_levels() const { return log2_width + 1; }
+
+    constexpr bool operator==(pow2_extent1 const& rhs) const { return log2_width == rhs.log2_width; }
+    constexpr bool operator!=(pow2_extent1 const& rhs) const { return log2_width != rhs.log2_width; }
+};
+
+template <class In>
+constexpr void introspect(In&& inspect, pow2_extent1& v)
+{
+    inspect(v.log2_width, "log2_width");
+}
+
+struct pow2_extent2
+{
+    int log2_width = -1;
+    int log2_height = -1;
+
+    tg::ivec2 to_ivec() const { return {detail::pow2_or_zero(log2_width), detail::pow2_or_zero(log2_height)}; }
+    static pow2_extent2 from_ivec(tg::ivec2 const& e) { return {detail::log2_of_pow2(e.x), detail::log2_of_pow2(e.y)}; }
+    uint64_t pixel_count() const { return log2_width < 0 || log2_height < 0 ? 0 : uint64_t(1) << (log2_width + log2_height); }
+
+    /// extent of the given mip level (each dimension is halved down to 1)
+    pow2_extent2 mip_extent(int level) const { return {detail::mip_log2(log2_width, level), detail::mip_log2(log2_height, level)}; }
+    /// number of mip levels down to a single pixel
+    int mip_levels() const { return (log2_width > log2_height ? log2_width : log2_height) + 1; }
+
+    constexpr bool operator==(pow2_extent2 const& rhs) const { return log2_width == rhs.log2_width && log2_height == rhs.log2_height; }
+    constexpr bool operator!=(pow2_extent2 const& rhs) const { return log2_width != rhs.log2_width || log2_height != rhs.log2_height; }
+};
+
+template <class In>
+constexpr void introspect(In&& inspect, pow2_extent2& v)
+{
+    inspect(v.log2_width, "log2_width");
+    inspect(v.log2_height, "log2_height");
+}
+
+struct pow2_extent3
+{
+    int log2_width = -1;
+    int log2_height = -1;
+    int log2_depth = -1;
+
+    tg::ivec3 to_ivec() const
+    {
+        return {detail::pow2_or_zero(log2_width), detail::pow2_or_zero(log2_height), detail::pow2_or_zero(log2_depth)};
+    }
+    static pow2_extent3 from_ivec(tg::ivec3 const& e)
+    {
+        return {detail::log2_of_pow2(e.x), detail::log2_of_pow2(e.y), detail::log2_of_pow2(e.z)};
+    }
+    uint64_t pixel_count() const
+    {
+        return log2_width < 0 || log2_height < 0 || log2_depth < 0 ? 0 : uint64_t(1) << (log2_width + log2_height + log2_depth);
+    }
+
+    /// extent of the given mip level (each dimension is halved down to 1)
+    pow2_extent3 mip_extent(int level) const
+    {
+        return {detail::mip_log2(log2_width, level), detail::mip_log2(log2_height, level), detail::mip_log2(log2_depth, level)};
+    }
+    /// number of mip levels down to a single pixel
+    int mip_levels() const
+    {
+        auto m = log2_width > log2_height ? log2_width : log2_height;
+        return (m > log2_depth ? m : log2_depth) + 1;
+    }
+
+    constexpr bool operator==(pow2_extent3 const& rhs) const
+    {
+        return log2_width == rhs.log2_width && log2_height == rhs.log2_height && log2_depth == rhs.log2_depth;
+    }
+    constexpr bool operator!=(pow2_extent3 const& rhs) const { return !operator==(rhs); }
+};
+
+template <class In>
+constexpr void introspect(In&& inspect, pow2_extent3& v)
+{
+    inspect(v.log2_width, "log2_width");
+    inspect(v.log2_height, "log2_height");
+    inspect(v.log2_depth, "log2_depth");
+}
+
+namespace detail
+{
+template <>
+struct is_pow2_extent_t<pow2_extent1> : std::true_type
+{
+};
+template <>
+struct is_pow2_extent_t<pow2_extent2> : std::true_type
+{
+};
+template <>
+struct is_pow2_extent_t<pow2_extent3> : std::true_type
+{
+};
+}
+
+template <class ExtentT>
+static constexpr bool is_pow2_extent = detail::is_pow2_extent_t<ExtentT>::value;
 }
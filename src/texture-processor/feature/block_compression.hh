@@ -0,0 +1,301 @@
+#pragma once
+
+#include <type_traits>
+
+#include <clean-core/array.hh>
+#include <clean-core/optional.hh>
+#include <clean-core/vector.hh>
+
+#include <texture-processor/blocks.hh>
+#include <texture-processor/convert.hh>
+#include <texture-processor/execution.hh>
+#include <texture-processor/image.hh>
+#include <texture-processor/image_view.hh>
+#include <texture-processor/raw_image.hh>
+
+/**
+ * This file contains functions to work with block-compressed (BCn) images
+ *
+ * block images are image<base_traits::block2D<tg::color4, blockXYZ>>
+ * their pixels can be read individually (decoded on access)
+ * but decompressing the whole image is much faster as every block is decoded only once
+ *
+ * compression accepts any 2D image with up to 4 channels (e.g. tg::color4 or u8 rgba)
+ * with tp::par, block rows are distributed over the thread pool
+ *
+ * sRGB textures use the sRGB block types (blockDXT1_sRGB, blockDXT3_sRGB, blockDXT5_sRGB),
+ * which decode to and encode from linear pixels
+ *
+ * HDR data uses BC6H (blockBC6H_UF16 / blockBC6H_SF16), e.g.
+ *    auto bc = tp::compress_blocks_to_raw<tp::blockBC6H_UF16>(tp::par, hdr_image, tp::bc_quality::high);
+ *    auto rgb = tp::decompress_blocks_to<tg::comp<3, tg::half>>(tp::par, bc_image);
+ */
+
+namespace tp
+{
+template <class BlockT>
+using block_image = image<base_traits::block2D<tg::color4, BlockT>>;
+
+namespace detail
+{
+/// converts a pixel to normalized rgba (missing channels are 0, missing alpha is 1)
+template <class PixelT>
+tg::color4 to_rgba(PixelT const& p)
+{
+    if constexpr (std::is_same_v<PixelT, tg::color4>)
+        return p;
+    else if constexpr (std::is_arithmetic_v<PixelT>)
+    {
+        tg::color4 c = {0.f, 0.f, 0.f, 1.f};
+        default_converter{}(c.r, p);
+        return c;
+    }
+    else
+    {
+        constexpr auto channels = pixel_traits<PixelT>::channels;
+        tg::color4 c = {0.f, 0.f, 0.f, 1.f};
+        for (auto i = 0; i < (channels < 4 ? channels : 4); ++i)
+            default_converter{}(c[i], p[i]);
+        return c;
+    }
+}
+
+/// converts normalized rgba to a pixel (surplus channels are dropped)
+template <class PixelT>
+PixelT from_rgba(tg::color4 const& c)
+{
+    if constexpr (std::is_same_v<PixelT, tg::color4>)
+        return c;
+    else if constexpr (std::is_arithmetic_v<PixelT>)
+    {
+        PixelT p;
+        default_converter{}(p, c.r);
+        return p;
+    }
+    else
+    {
+        constexpr auto channels = pixel_traits<PixelT>::channels;
+        PixelT p;
+        for (auto i = 0; i < (channels < 4 ? channels : 4); ++i)
+            default_converter{}(p[i], c[i]);
+        return p;
+    }
+}
+
+/// runs f(i) for i in [0, count), on the pool of a parallel policy
+template <class ExecutionPolicy, class F>
+void run_indexed(ExecutionPolicy const& policy, int64_t count, F&& f)
+{
+    if constexpr (std::is_same_v<ExecutionPolicy, parallel_policy>)
+        policy.get_pool().parallel_for(count, f);
+    else
+        for (int64_t i = 0; i < count; ++i)
+            f(i);
+}
+
+/// encodes img into the row-major blocks at out (border blocks are padded by clamping)
+template <class BlockT, class ExecutionPolicy, class ViewT>
+void encode_blocks(ExecutionPolicy const& policy, ViewT const& img, bc_quality quality, BlockT* out)
+{
+    static_assert(ViewT::dimensions == 2, "only 2D images can be block-compressed");
+    constexpr auto bw = BlockT::block_sizes[0];
+    constexpr auto bh = BlockT::block_sizes[1];
+
+    auto const w = img.width();
+    auto const h = img.height();
+    if (w == 0 || h == 0)
+        return;
+    auto const blocks_x = (w + bw - 1) / bw;
+    auto const blocks_y = (h + bh - 1) / bh;
+
+    run_indexed(policy, blocks_y, [&](int64_t by) {
+        tg::color4 px[bw * bh];
+        for (auto bx = 0; bx < blocks_x; ++bx)
+        {
+            for (auto y = 0; y < bh; ++y)
+            {
+                auto const sy = int(by) * bh + y < h ? int(by) * bh + y : h - 1;
+                for (auto x = 0; x < bw; ++x)
+                {
+                    auto const sx = bx * bw + x < w ? bx * bw + x : w - 1;
+                    px[y * bw + x] = to_rgba(img.at_unchecked({sx, sy}));
+                }
+            }
+            out[by * blocks_x + bx].encode(px, quality);
+        }
+    });
+}
+
+/// 2x2 box filter for mip chains (odd extents average the available pixels)
+template <class ExecutionPolicy>
+image2<tg::color4> downsample_rgba_2x2(ExecutionPolicy const& policy, image2_view<tg::color4> const& src)
+{
+    auto const w = src.width() > 1 ? src.width() / 2 : 1;
+    auto const h = src.height() > 1 ? src.height() / 2 : 1;
+    auto res = image2<tg::color4>::uninitialized({w, h});
+    res.for_each(policy, [&](tg::ipos2 p, tg::color4& v) {
+        tg::color4 sum = {0.f, 0.f, 0.f, 0.f};
+        auto n = 0;
+        for (auto dy = 0; dy < 2; ++dy)
+            for (auto dx = 0; dx < 2; ++dx)
+            {
+                auto const sx = p.x * 2 + dx;
+                auto const sy = p.y * 2 + dy;
+                if (sx >= src.width() || sy >= src.height())
+                    continue;
+                auto const& c = src.at_unchecked({sx, sy});
+                sum = {sum.r + c.r, sum.g + c.g, sum.b + c.b, sum.a + c.a};
+                ++n;
+            }
+        v = {sum.r / float(n), sum.g / float(n), sum.b / float(n), sum.a / float(n)};
+    });
+    return res;
+}
+
+/// the sRGB variant of a linear block type (void if there is none)
+template <class BlockT>
+struct srgb_block_of
+{
+    using type = void;
+};
+template <>
+struct srgb_block_of<blockDXT1>
+{
+    using type = blockDXT1_sRGB;
+};
+template <>
+struct srgb_block_of<blockDXT3>
+{
+    using type = blockDXT3_sRGB;
+};
+template <>
+struct srgb_block_of<blockDXT5>
+{
+    using type = blockDXT5_sRGB;
+};
+
+/// encodes img into a raw_image with the metadata of BlockT
+template <class BlockT, class ExecutionPolicy, class ImageOrViewT>
+raw_image encode_blocks_to_raw(ExecutionPolicy const& policy, ImageOrViewT const& img, bc_quality quality)
+{
+    using view_t = image_view<base_traits::block2D<tg::color4, BlockT>>;
+    using storage_view_t = typename view_t::storage_view_t;
+
+    auto const e = img.extent().to_ivec();
+    auto data = cc::array<std::byte>::uninitialized(storage_view_t::storage_size_for(e) * sizeof(BlockT));
+    encode_blocks(policy, img, quality, reinterpret_cast<BlockT*>(data.data()));
+
+    auto const md = view_t::from_data(data.data(), img.extent(), storage_view_t::natural_stride_for(e)).metadata();
+    return raw_image(md, cc::move(data));
+}
+}
+
+/// decodes a block-compressed image into a linear image
+/// NOTE: sRGB blocks (e.g. blockDXT1_sRGB) are converted to linear values
+template <class ImageOrViewT>
+[[nodiscard]] image2<tg::color4> decompress_blocks(ImageOrViewT const& img)
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+    static_assert(ImageOrViewT::traits::is_block_based, "only block-based images can be decompressed");
+
+    auto res = image2<tg::color4>::uninitialized(img.extent());
+    img.copy_to(res);
+    return res;
+}
+template <class ExecutionPolicy, class ImageOrViewT>
+[[nodiscard]] image2<tg::color4> decompress_blocks(ExecutionPolicy const& policy, ImageOrViewT const& img)
+{
+    static_assert(is_execution_policy<ExecutionPolicy>, "first argument must be an execution policy");
+    static_assert(is_image_or_view<ImageOrViewT>);
+    static_assert(ImageOrViewT::traits::is_block_based, "only block-based images can be decompressed");
+
+    auto res = image2<tg::color4>::uninitialized(img.extent());
+    img.copy_to(policy, res);
+    return res;
+}
+
+/// decodes a block-compressed image into a linear image of the given pixel type
+/// e.g. tg::comp<3, float> or tg::comp<3, tg::half> for BC6H, u8 vectors for BC1-BC5
+template <class PixelT, class ExecutionPolicy, class ImageOrViewT>
+[[nodiscard]] image2<PixelT> decompress_blocks_to(ExecutionPolicy const& policy, ImageOrViewT const& img)
+{
+    static_assert(is_execution_policy<ExecutionPolicy>, "first argument must be an execution policy");
+    static_assert(is_image_or_view<ImageOrViewT>);
+    static_assert(ImageOrViewT::traits::is_block_based, "only block-based images can be decompressed");
+
+    auto res = image2<PixelT>::uninitialized(img.extent());
+    img.copy_to(policy, res, [](PixelT& t, tg::color4 const& c) { t = detail::from_rgba<PixelT>(c); });
+    return res;
+}
+template <class PixelT, class ImageOrViewT>
+[[nodiscard]] image2<PixelT> decompress_blocks_to(ImageOrViewT const& img)
+{
+    return decompress_blocks_to<PixelT>(seq, img);
+}
+
+/// encodes a 2D image into a block-compressed image
+/// usage:
+///    auto bc = tp::compress_blocks<tp::blockDXT5>(tp::par, my_rgba_image, tp::bc_quality::high);
+template <class BlockT, class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] block_image<BlockT> compress_blocks(ExecutionPolicy const& policy, ImageOrViewT const& img, bc_quality quality = bc_quality::fast)
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+
+    auto res = block_image<BlockT>::uninitialized(img.extent());
+    detail::encode_blocks(policy, img, quality, res.blocks().data());
+    return res;
+}
+template <class BlockT, class ImageOrViewT>
+[[nodiscard]] block_image<BlockT> compress_blocks(ImageOrViewT const& img, bc_quality quality = bc_quality::fast)
+{
+    return compress_blocks<BlockT>(seq, img, quality);
+}
+
+/// encodes a 2D image into a raw_image with block-compressed data and matching metadata
+/// if is_srgb is set, the sRGB variant of the format is stored (only BC1-BC3, see blockDXT1_sRGB)
+/// NOTE: pixels are always linear, the sRGB variant converts them before encoding
+template <class BlockT, class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] raw_image compress_blocks_to_raw(ExecutionPolicy const& policy, ImageOrViewT const& img, bc_quality quality = bc_quality::fast, bool is_srgb = false)
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+    using srgb_block_t = typename detail::srgb_block_of<BlockT>::type;
+
+    if constexpr (!std::is_void_v<srgb_block_t>)
+    {
+        if (is_srgb)
+            return detail::encode_blocks_to_raw<srgb_block_t>(policy, img, quality);
+    }
+    else
+        CC_ASSERT(!is_srgb && "format has no sRGB variant");
+
+    return detail::encode_blocks_to_raw<BlockT>(policy, img, quality);
+}
+
+/// encodes a 2D image and all its mip levels (2x2 box filtered) into block-compressed images
+/// max_levels limits the number of levels (including the original), per default the chain goes down to 1x1
+template <class BlockT, class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] cc::vector<block_image<BlockT>> compress_blocks_with_mipmaps(ExecutionPolicy const& policy,
+                                                                          ImageOrViewT const& img,
+                                                                          bc_quality quality = bc_quality::fast,
+                                                                          cc::optional<int> max_levels = {})
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+
+    cc::vector<block_image<BlockT>> res;
+    if (img.empty())
+        return res;
+
+    res.push_back(compress_blocks<BlockT>(policy, img, quality));
+
+    // mip levels are filtered in linear float rgba
+    auto level = image2<tg::color4>::uninitialized(img.extent());
+    img.for_each(policy, [&](tg::ipos2 p, auto const& v) { level.at_unchecked(p) = detail::to_rgba(v); });
+
+    while ((!max_levels.has_value() || int(res.size()) < max_levels.value()) && (level.width() > 1 || level.height() > 1))
+    {
+        level = detail::downsample_rgba_2x2(policy, level);
+        res.push_back(compress_blocks<BlockT>(policy, level, quality));
+    }
+    return res;
+}
+}
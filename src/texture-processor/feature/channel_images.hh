@@ -0,0 +1,138 @@
+#pragma once
+
+#include <type_traits>
+
+#include <clean-core/optional.hh>
+#include <clean-core/span.hh>
+#include <clean-core/vector.hh>
+
+#include <texture-processor/convert.hh>
+#include <texture-processor/detail/channels.hh>
+#include <texture-processor/execution.hh>
+#include <texture-processor/image.hh>
+#include <texture-processor/image_view.hh>
+
+/**
+ * This file contains bulk kernels for images with a runtime channel count (channel_image1/2/3)
+ *
+ * pixels of such images are cc::span<ScalarT> with one element per channel, e.g.
+ *    auto img = tp::channel_image2<float>::filled({512, 512}, num_layers, 0.f);
+ *    img(10, 20)[layer] = 1.f;
+ *
+ * all kernels are specialized for 1 to 4 channels (unrolled channel loops) and fall back to a generic loop otherwise
+ */
+
+namespace tp
+{
+namespace detail
+{
+/// average of n accumulated values, integral types are rounded
+template <class T, class AccT>
+T average_of(AccT sum, int n)
+{
+    if constexpr (std::is_integral_v<T>)
+        return T(sum / AccT(n) + AccT(0.5));
+    else
+        return T(sum / AccT(n));
+}
+}
+
+/// converts each channel to TargetT (using the default converter, i.e. u8 and u16 are treated as normalized)
+template <class TargetT, class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] image<base_traits::dynamic_channels<TargetT, typename ImageOrViewT::extent_t, ImageOrViewT::dimensions, ImageOrViewT::traits::image_type>>
+convert_channels(ExecutionPolicy const& policy, ImageOrViewT const& img)
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+    static_assert(ImageOrViewT::has_dynamic_channels, "only images with a runtime channel count are supported");
+    using image_t = image<base_traits::dynamic_channels<TargetT, typename ImageOrViewT::extent_t, ImageOrViewT::dimensions, ImageOrViewT::traits::image_type>>;
+
+    auto res = image_t::uninitialized(img.extent(), img.channel_count());
+    img.copy_to(policy, res);
+    return res;
+}
+template <class TargetT, class ImageOrViewT>
+[[nodiscard]] auto convert_channels(ImageOrViewT const& img)
+{
+    return convert_channels<TargetT>(seq, img);
+}
+
+/// creates a 2x downsampled 2D image by averaging 2x2 pixels per channel (odd extents average the available pixels)
+template <class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] auto downsample_channels_2x2(ExecutionPolicy const& policy, ImageOrViewT const& img) -> image_type_of<ImageOrViewT>
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+    static_assert(ImageOrViewT::has_dynamic_channels, "only images with a runtime channel count are supported");
+    static_assert(ImageOrViewT::dimensions == 2, "only 2D images are supported");
+    using scalar_t = std::remove_const_t<typename ImageOrViewT::pixel_t>;
+    using acc_t = std::conditional_t<std::is_same_v<scalar_t, double>, double, float>;
+
+    auto const c = img.channel_count();
+    auto const w = img.width() > 1 ? img.width() / 2 : 1;
+    auto const h = img.height() > 1 ? img.height() / 2 : 1;
+    auto res = image_type_of<ImageOrViewT>::uninitialized({w, h}, c);
+
+    detail::dispatch_channel_count(c, [&](auto n) {
+        constexpr int N = decltype(n)::value;
+        res.for_each(policy, [&](tg::ipos2 p, cc::span<scalar_t> v) {
+            auto const x0 = p.x * 2;
+            auto const y0 = p.y * 2;
+            auto const x1 = x0 + 1 < img.width() ? x0 + 1 : x0;
+            auto const y1 = y0 + 1 < img.height() ? y0 + 1 : y0;
+            auto const cnt = (x1 - x0 + 1) * (y1 - y0 + 1);
+
+            auto const s00 = img.at_unchecked({x0, y0}).data();
+            auto const s10 = img.at_unchecked({x1, y0}).data();
+            auto const s01 = img.at_unchecked({x0, y1}).data();
+            auto const s11 = img.at_unchecked({x1, y1}).data();
+
+            // at odd borders, the missing neighbors are skipped
+            for (auto k = 0; k < (N > 0 ? N : c); ++k)
+            {
+                auto sum = acc_t(s00[k]);
+                if (x1 != x0)
+                    sum += acc_t(s10[k]);
+                if (y1 != y0)
+                    sum += acc_t(s01[k]);
+                if (x1 != x0 && y1 != y0)
+                    sum += acc_t(s11[k]);
+                v[k] = detail::average_of<scalar_t>(sum, cnt);
+            }
+        });
+    });
+    return res;
+}
+template <class ImageOrViewT>
+[[nodiscard]] auto downsample_channels_2x2(ImageOrViewT const& img) -> image_type_of<ImageOrViewT>
+{
+    return downsample_channels_2x2(seq, img);
+}
+
+/// creates the mip chain of a 2D image (including a copy of the original) by repeated 2x2 averaging
+/// max_levels limits the number of levels, per default the chain goes down to 1x1
+template <class ExecutionPolicy, class ImageOrViewT, class = std::enable_if_t<is_execution_policy<ExecutionPolicy>>>
+[[nodiscard]] auto generate_channel_mipmaps(ExecutionPolicy const& policy, ImageOrViewT const& img, cc::optional<int> max_levels = {})
+    -> cc::vector<image_type_of<ImageOrViewT>>
+{
+    static_assert(is_image_or_view<ImageOrViewT>);
+    using image_t = image_type_of<ImageOrViewT>;
+
+    cc::vector<image_t> res;
+    if (img.empty())
+        return res;
+
+    auto level = image_t::uninitialized(img.extent(), img.channel_count());
+    img.copy_to(policy, level);
+    res.push_back(cc::move(level));
+    while ((!max_levels.has_value() || int(res.size()) < max_levels.value()) && (res.back().width() > 1 || res.back().height() > 1))
+    {
+        auto next = downsample_channels_2x2(policy, res.back());
+        res.push_back(cc::move(next));
+    }
+    return res;
+}
+template <class ImageOrViewT>
+[[nodiscard]] auto generate_channel_mipmaps(ImageOrViewT const& img, cc::optional<int> max_levels = {}) -> cc::vector<image_type_of<ImageOrViewT>>
+{
+    return generate_channel_mipmaps(seq, img, max_levels);
+}
+}
@@ -2,6 +2,7 @@
 
 #include <texture-processor/image.hh>
 #include <texture-processor/image_view.hh>
+#include <texture-processor/procedural.hh>
 
 /**
  * This file contains various functions to fill images with procedural content
@@ -9,6 +10,9 @@
  * Each method has two versions:
  *  * fill_with_xyz(view, ...)          - fills the given view
  *  * generate_xyz<image>(extents, ...) - generates new image
+ *
+ * some are additionally available as lazy views that compute their pixels on access (see procedural.hh):
+ *  * xyz_view(extents, ...)
  */
 
 namespace tp
@@ -22,5 +26,24 @@ void fill_with_checkerboard(ImageOrViewT& img, pixel_type_of<ImageOrViewT> const
     for (auto&& [pos, value] : img)
         value = detail::pos_sum(pos) % 2 == 0 ? val_even : val_odd;
 }
+template <class ExecutionPolicy, class ImageOrViewT>
+void fill_with_checkerboard(ExecutionPolicy const& policy,
+                            ImageOrViewT& img,
+                            pixel_type_of<ImageOrViewT> const& val_even,
+                            pixel_type_of<ImageOrViewT> const& val_odd)
+{
+    static_assert(is_execution_policy<ExecutionPolicy>, "first argument must be an execution policy");
+    static_assert(is_image_or_view<ImageOrViewT>);
+
+    using ipos_t = typename ImageOrViewT::ipos_t;
+    using pixel_access_t = typename ImageOrViewT::pixel_access_t;
+    img.for_each(policy, [&](ipos_t const& pos, pixel_access_t value) { value = detail::pos_sum(pos) % 2 == 0 ? val_even : val_odd; });
+}
+/// read-only view of a checkerboard pattern (nothing is stored besides the two values)
+template <class ExtentT, class PixelT>
+[[nodiscard]] auto checkerboard_view(ExtentT const& extent, PixelT const& val_even, PixelT const& val_odd)
+{
+    return procedural_view(extent, [val_even, val_odd](auto const& pos) -> PixelT { return detail::pos_sum(pos) % 2 == 0 ? val_even : val_odd; });
+}
 
 }
@@ -22,4 +22,17 @@ template <class ImageOrViewT>
         res.push_back(tp::downsample_by_2x_averaging(res.back()));
     return res;
 }
+
+/// same as above, but the image becomes level 0 without copying its pixels
+/// (e.g. generate_mipmaps_by_averaging(shared.release()) moves the pixels out of a shared_image that is not shared)
+template <class Traits>
+[[nodiscard]] auto generate_mipmaps_by_averaging(image<Traits>&& img, cc::optional<int> max_level = {}) -> cc::vector<image<Traits>>
+{
+    cc::vector<image<Traits>> res;
+    res.push_back(cc::move(img));
+    while ((!max_level.has_value() || int(res.size()) < max_level.value()) && //
+           detail::downsampled_extent(res.back().extent()) != res.back().extent())
+        res.push_back(tp::downsample_by_2x_averaging(res.back()));
+    return res;
+}
 }
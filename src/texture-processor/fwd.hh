@@ -9,6 +9,15 @@ template <class BaseTraits>
 struct image;
 template <class BaseTraits>
 struct image_view;
+template <class BaseTraits>
+struct shared_image;
+struct selection;
+
+struct allocator;
+struct heap_allocator;
+struct huge_page_allocator;
+struct arena_allocator;
+struct pool_allocator;
 
 //
 // extents
@@ -19,6 +28,15 @@ struct extent3;
 struct extent1_array;
 struct extent2_array;
 struct extent_cube;
+template <int W>
+struct fixed_extent1;
+template <int W, int H>
+struct fixed_extent2;
+template <int W, int H, int D>
+struct fixed_extent3;
+struct pow2_extent1;
+struct pow2_extent2;
+struct pow2_extent3;
 
 //
 // storage
@@ -29,28 +47,81 @@ template <class T, class BlockT>
 struct linear_block_storage;
 template <class T>
 struct z_storage;
+template <class T>
+struct tiled_storage;
+template <class T>
+struct planar_storage;
 
 //
 // storage views
 //
 template <class T>
 struct linear_storage_view;
+template <class T, class ExtentT>
+struct fixed_linear_storage_view;
+template <class StorageViewT>
+struct fixed_stride;
+template <class T, int D>
+struct pow2_linear_storage_view;
+template <class StorageViewT>
+struct pow2_stride;
+template <class T, int D>
+struct channel_storage_view;
+template <int D>
+struct channel_stride;
+template <class T, int D>
+struct planar_storage_view;
+template <int D>
+struct planar_stride;
+template <class T, int D, class GetterF, class SetterF>
+struct procedural_storage_view;
+template <int D, class GetterF, class SetterF>
+struct procedural_state;
 template <class T, class BlockT>
 struct linear_block_storage_view;
 template <class T>
 struct z_storage_view;
+template <class T, int TileW, int TileH, int TileD>
+struct tiled_storage_view;
 
 //
 // iteration
 //
+template <int D, class PixelT>
+struct pixel_run;
 namespace detail
 {
 template <int D>
 struct strided_linear_pos_iterator;
 template <int D, class StorageViewT>
+struct strided_linear_row_iterator;
+template <int D, class StorageViewT>
 struct strided_linear_pixel_iterator;
 template <int D, class StorageViewT>
 struct strided_linear_entry_iterator;
+struct z_order_pos_iterator;
+template <class StorageViewT>
+struct z_order_pixel_iterator;
+template <class StorageViewT>
+struct z_order_entry_iterator;
+template <class StorageViewT>
+struct block_pos_iterator;
+template <class StorageViewT>
+struct block_pixel_iterator;
+template <class StorageViewT>
+struct block_entry_iterator;
+template <int D, class StorageViewT>
+struct tiled_pos_iterator;
+template <int D, class StorageViewT>
+struct tiled_row_iterator;
+template <int D, class StorageViewT>
+struct tiled_pixel_iterator;
+template <int D, class StorageViewT>
+struct tiled_entry_iterator;
+template <int D, class StorageViewT>
+struct addressed_pixel_iterator;
+template <int D, class StorageViewT>
+struct addressed_entry_iterator;
 }
 
 //
@@ -62,23 +133,147 @@ struct traits;
 namespace base_traits
 {
 template <class PixelT>
+struct linear1D;
+template <class PixelT>
 struct linear2D;
+template <class PixelT>
+struct linear3D;
+template <class PixelT>
+struct linear1D_array;
+template <class PixelT>
+struct linear2D_array;
+template <class PixelT>
+struct linear_cube;
 template <class PixelT, class BlockT>
 struct block2D;
 template <class PixelT>
 struct z2D;
+template <class PixelT, int TileW, int TileH>
+struct tiled2D;
+template <class PixelT, int TileW, int TileH, int TileD>
+struct tiled3D;
+template <class PixelT, int W>
+struct fixed1D;
+template <class PixelT, int W, int H>
+struct fixed2D;
+template <class PixelT, int W, int H, int D>
+struct fixed3D;
+template <class PixelT>
+struct pow2_1D;
+template <class PixelT>
+struct pow2_2D;
+template <class PixelT>
+struct pow2_3D;
+template <class ScalarT>
+struct channels1D;
+template <class ScalarT>
+struct channels2D;
+template <class ScalarT>
+struct channels3D;
+template <class PixelT>
+struct planar2D;
+template <class PixelT>
+struct planar3D;
+template <class PixelT, class MaterializedT, class GetterF, class SetterF>
+struct procedural;
 }
 
 //
 // predefined images
 //
 template <class PixelT>
+using image1 = image<base_traits::linear1D<PixelT>>;
+template <class PixelT>
 using image2 = image<base_traits::linear2D<PixelT>>;
+template <class PixelT>
+using image3 = image<base_traits::linear3D<PixelT>>;
+template <class PixelT>
+using image1_array = image<base_traits::linear1D_array<PixelT>>;
+template <class PixelT>
+using image2_array = image<base_traits::linear2D_array<PixelT>>;
+template <class PixelT>
+using image_cube = image<base_traits::linear_cube<PixelT>>;
+template <class PixelT, int TileW = 32, int TileH = 32>
+using tiled_image2 = image<base_traits::tiled2D<PixelT, TileW, TileH>>;
+template <class PixelT, int TileW = 16, int TileH = 16, int TileD = 16>
+using tiled_image3 = image<base_traits::tiled3D<PixelT, TileW, TileH, TileD>>;
+template <class PixelT, int W>
+using fixed_image1 = image<base_traits::fixed1D<PixelT, W>>;
+template <class PixelT, int W, int H>
+using fixed_image2 = image<base_traits::fixed2D<PixelT, W, H>>;
+template <class PixelT, int W, int H, int D>
+using fixed_image3 = image<base_traits::fixed3D<PixelT, W, H, D>>;
+template <class PixelT>
+using pow2_image1 = image<base_traits::pow2_1D<PixelT>>;
+template <class PixelT>
+using pow2_image2 = image<base_traits::pow2_2D<PixelT>>;
+template <class PixelT>
+using pow2_image3 = image<base_traits::pow2_3D<PixelT>>;
+template <class ScalarT>
+using channel_image1 = image<base_traits::channels1D<ScalarT>>;
+template <class ScalarT>
+using channel_image2 = image<base_traits::channels2D<ScalarT>>;
+template <class ScalarT>
+using channel_image3 = image<base_traits::channels3D<ScalarT>>;
+template <class PixelT>
+using planar_image2 = image<base_traits::planar2D<PixelT>>;
+template <class PixelT>
+using planar_image3 = image<base_traits::planar3D<PixelT>>;
+
+//
+// predefined shared (copy-on-write) images
+//
+template <class PixelT>
+using shared_image1 = shared_image<base_traits::linear1D<PixelT>>;
+template <class PixelT>
+using shared_image2 = shared_image<base_traits::linear2D<PixelT>>;
+template <class PixelT>
+using shared_image3 = shared_image<base_traits::linear3D<PixelT>>;
+template <class PixelT>
+using shared_image2_array = shared_image<base_traits::linear2D_array<PixelT>>;
+template <class PixelT>
+using shared_image_cube = shared_image<base_traits::linear_cube<PixelT>>;
 
 //
 // predefined views
 //
 template <class PixelT>
+using image1_view = image_view<base_traits::linear1D<PixelT>>;
+template <class PixelT>
 using image2_view = image_view<base_traits::linear2D<PixelT>>;
+template <class PixelT>
+using image3_view = image_view<base_traits::linear3D<PixelT>>;
+template <class PixelT>
+using image1_array_view = image_view<base_traits::linear1D_array<PixelT>>;
+template <class PixelT>
+using image2_array_view = image_view<base_traits::linear2D_array<PixelT>>;
+template <class PixelT>
+using image_cube_view = image_view<base_traits::linear_cube<PixelT>>;
+template <class PixelT, int TileW = 32, int TileH = 32>
+using tiled_image2_view = image_view<base_traits::tiled2D<PixelT, TileW, TileH>>;
+template <class PixelT, int TileW = 16, int TileH = 16, int TileD = 16>
+using tiled_image3_view = image_view<base_traits::tiled3D<PixelT, TileW, TileH, TileD>>;
+template <class PixelT, int W>
+using fixed_image1_view = image_view<base_traits::fixed1D<PixelT, W>>;
+template <class PixelT, int W, int H>
+using fixed_image2_view = image_view<base_traits::fixed2D<PixelT, W, H>>;
+template <class PixelT, int W, int H, int D>
+using fixed_image3_view = image_view<base_traits::fixed3D<PixelT, W, H, D>>;
+template <class PixelT>
+using pow2_image1_view = image_view<base_traits::pow2_1D<PixelT>>;
+template <class PixelT>
+using pow2_image2_view = image_view<base_traits::pow2_2D<PixelT>>;
+template <class PixelT>
+using pow2_image3_view = image_view<base_traits::pow2_3D<PixelT>>;
+template <class ScalarT>
+using channel_image1_view = image_view<base_traits::channels1D<ScalarT>>;
+template <class ScalarT>
+using channel_image2_view = image_view<base_traits::channels2D<ScalarT>>;
+template <class ScalarT>
+using channel_image3_view = image_view<base_traits::channels3D<ScalarT>>;
+template <class PixelT>
+using planar_image2_view = image_view<base_traits::planar2D<PixelT>>;
+template <class PixelT>
+using planar_image3_view = image_view<base_traits::planar3D<PixelT>>;
 
 }
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstring>
+#include <type_traits>
+
+#include <clean-core/span.hh>
+
 #include <texture-processor/image_view.hh>
 #include <texture-processor/storage.hh>
 
@@ -10,8 +15,7 @@ namespace tp
  * Basically the value-semantics owning version of image_view
  * It can also be thought of as a cc::vector but with an image API
  *
- * TODO:
- *  - how are non-natural strides handled in creation/resize?
+ * images are stored compactly, except that rows of linear images can be padded (see set_row_alignment)
  *
  * NOTE: views into this image remain valid if the image is moved!
  */
@@ -23,38 +27,74 @@ struct image : image_view<BaseTraits>
     using pixel_t = typename traits::pixel_t;
     using pos_t = typename traits::pos_t;
     using ipos_t = typename traits::ipos_t;
+    using ivec_t = typename traits::ivec_t;
     using extent_t = typename traits::extent_t;
     using storage_t = typename traits::storage_t;
     using storage_view_t = typename traits::storage_view_t;
     using data_ptr_t = typename storage_view_t::data_ptr_t;
 
+    static constexpr int dimensions = traits::dimensions;
+
+    /// true if rows can be padded (linear images with a runtime extent and at least two dimensions)
+    static constexpr bool has_row_padding = std::is_same_v<storage_view_t, linear_storage_view<pixel_t>> && dimensions >= 2;
+
     // ctors and creation
 public:
     image() = default;
     ~image() = default;
 
+    /// creates an empty image that allocates its pixels from the given allocator (see allocator.hh)
+    /// NOTE: the allocator must outlive the image
+    explicit image(allocator& alloc) { this->_storage.set_allocator(alloc); }
+
     // moving storage does not change the data_ptr
     image(image&& rhs) noexcept = default;
     image& operator=(image&& rhs) noexcept = default;
 
-    // copy results in natural stride again
-    // TODO: would it be better to retain original stride?
-    image(image const& rhs)
+    // copies keep the layout (row alignment), so the storage is copied as a whole
+    // (pixels are copy-constructed in place, i.e. a single pass over memory)
+    // NOTE: copies allocate from the heap (like std::pmr containers), assignment keeps the allocator of the target
+    image(image const& rhs) : image_view<BaseTraits>(), _storage(rhs._storage), _row_alignment(rhs._row_alignment)
     {
-        // TODO: replace by unitialized and copy_construct_to
-        resize(rhs.extent());
-        rhs.copy_to(*this);
+        adopt_channel_count(rhs);
+        this->init_data_view(rhs.extent());
     }
     image& operator=(image const& rhs)
     {
-        resize(rhs.extent());
-        rhs.copy_to(*this);
+        if (this != &rhs)
+            copy_from_image(rhs);
+        return *this;
     }
 
     /// copies the view into this image
     explicit image(image_view<BaseTraits> view)
     {
-        resize(view.extent());
+        if constexpr (traits::is_block_based)
+        {
+            // copy the blocks row by row
+            resize_uninitialized(view.extent());
+            auto const row_size = size_t(this->_byte_stride.y);
+            auto const block_rows = (view.height() + storage_view_t::block_height - 1) / storage_view_t::block_height;
+            auto dst = reinterpret_cast<std::byte*>(this->_storage.data());
+            for (auto y = 0; y < block_rows; ++y)
+                std::memcpy(dst + y * row_size, view.data_ptr() + int64_t(y) * view.byte_stride().y, row_size);
+        }
+        else
+        {
+            adopt_channel_count(view);
+            resize_for_copy(view.extent());
+            view.copy_to(*this);
+        }
+    }
+
+    /// materializes a view of another kind with the same pixel type (e.g. a procedural, planar or broadcasting view)
+    template <class ViewTraits>
+    explicit image(image_view<ViewTraits> view)
+    {
+        static_assert(!traits::is_block_based, "block-based images can only be created from their own views");
+        static_assert(std::is_same_v<std::remove_const_t<typename image_view<ViewTraits>::pixel_t>, pixel_t>, "pixel types must match");
+        adopt_channel_count(view);
+        resize_for_copy(view.extent());
         view.copy_to(*this);
     }
 
@@ -81,41 +121,482 @@ public:
         return img;
     }
 
-    // TODO: this does not preserve content, which might be weird
+    /// same as filled, defaulted and uninitialized, but the pixels are allocated from the given allocator
+    [[nodiscard]] static image filled(extent_t e, pixel_t const& initial_value, allocator& alloc)
+    {
+        image img(alloc);
+        img.resize(e, initial_value);
+        return img;
+    }
+    [[nodiscard]] static image defaulted(extent_t e, allocator& alloc)
+    {
+        image img(alloc);
+        img.resize(e);
+        return img;
+    }
+    [[nodiscard]] static image uninitialized(extent_t e, allocator& alloc)
+    {
+        image img(alloc);
+        img.resize_uninitialized(e);
+        return img;
+    }
+
+    /// same as filled and defaulted, but the pixels are initialized with an explicit execution policy
+    /// with tp::par, the pixels are first written with the tiling of a parallel for_each
+    /// on NUMA systems, pages are placed on the node of the thread that touches them first,
+    /// so later parallel passes find their memory local (and creating huge images is faster)
+    /// NOTE: see resize(policy, ...) for when this applies
+    [[nodiscard]] static image filled(sequenced_policy, extent_t e, pixel_t const& initial_value) { return filled(e, initial_value); }
+    [[nodiscard]] static image filled(parallel_policy const& policy, extent_t e, pixel_t const& initial_value)
+    {
+        image img;
+        img.resize(policy, e, initial_value);
+        return img;
+    }
+    [[nodiscard]] static image defaulted(sequenced_policy, extent_t e) { return defaulted(e); }
+    [[nodiscard]] static image defaulted(parallel_policy const& policy, extent_t e)
+    {
+        image img;
+        img.resize(policy, e);
+        return img;
+    }
+
+    /// creation of images with a runtime channel count (the single-channel value of filled is used for all channels)
+    /// NOTE: the versions without a channel count keep the current one (new images have none, so they assert for non-empty extents)
+    template <class T = traits>
+    [[nodiscard]] static image filled(extent_t e, int channels, pixel_t const& initial_value)
+    {
+        image img;
+        img.set_channel_count<T>(channels);
+        img.resize(e, initial_value);
+        return img;
+    }
+    template <class T = traits>
+    [[nodiscard]] static image defaulted(extent_t e, int channels)
+    {
+        image img;
+        img.set_channel_count<T>(channels);
+        img.resize(e);
+        return img;
+    }
+    template <class T = traits>
+    [[nodiscard]] static image uninitialized(extent_t e, int channels)
+    {
+        image img;
+        img.set_channel_count<T>(channels);
+        img.resize_uninitialized(e);
+        return img;
+    }
+
+    /// NOTE: resize does not preserve content (see resize_preserving)
+    ///       the allocation is reused if the new size fits into the capacity (see reserve)
     void resize(extent_t e)
     {
-        this->_storage.resize_defaulted(e.pixel_count());
+        this->_storage.resize_defaulted(storage_size_for(e));
         this->init_data_view(e);
     }
     void resize(extent_t e, pixel_t const& fill_value)
     {
-        this->_storage.resize_filled(e.pixel_count(), fill_value);
+        this->_storage.resize_filled(storage_size_for(e), fill_value);
         this->init_data_view(e);
     }
     void resize_uninitialized(extent_t e)
     {
-        this->_storage.resize_uninitialized(e.pixel_count());
+        this->_storage.resize_uninitialized(storage_size_for(e));
         this->init_data_view(e);
     }
+    /// same as resize(e) and resize(e, fill_value), but the pixels are initialized with an explicit execution policy
+    /// with tp::par, a new allocation is left untouched and then filled in parallel tiles (parallel first-touch)
+    /// NOTE: this applies to trivially copyable pixels, others are constructed sequentially before the parallel fill
+    ///       reused capacity was already touched by whoever wrote it first
+    void resize(sequenced_policy, extent_t e) { resize(e); }
+    void resize(parallel_policy const& policy, extent_t e) { resize(policy, e, pixel_t()); }
+    void resize(sequenced_policy, extent_t e, pixel_t const& fill_value) { resize(e, fill_value); }
+    void resize(parallel_policy const& policy, extent_t e, pixel_t const& fill_value)
+    {
+        static_assert(!traits::is_block_based, "block images cannot be filled");
+        this->_storage.resize_for_overwrite(storage_size_for(e));
+        this->init_data_view(e);
+        this->fill(policy, fill_value);
+    }
+
+    template <class T = traits>
+    void resize_uninitialized(extent_t e, int channels)
+    {
+        set_channel_count<T>(channels);
+        resize_uninitialized(e);
+    }
+
+    /// resizes the image and keeps the pixels that are inside both the old and the new extent
+    /// all other pixels are set to fill_value
+    /// NOTE: if the new size fits into the capacity, the kept rows are moved in place (no allocation)
+    ///       this is the case for strided linear images with trivially copyable pixels,
+    ///       other images are copied into a new allocation
+    void resize_preserving(extent_t e, pixel_t const& fill_value = {})
+    {
+        static_assert(!traits::is_block_based, "block images cannot be resized preserving their content");
+
+        auto const old_e = this->_extent.to_ivec();
+        auto const new_e = e.to_ivec();
+        ivec_t keep;
+        for (auto d = 0; d < dimensions; ++d)
+            keep[d] = old_e[d] < new_e[d] ? old_e[d] : new_e[d];
+
+        constexpr bool is_row_movable = (storage_view_t::is_strided_linear || traits::has_dynamic_channels) && std::is_trivially_copyable_v<pixel_t>;
+        if constexpr (is_row_movable)
+        {
+            auto const old_stride = this->byte_stride();
+            if (storage_size_for(e) <= this->_storage.capacity())
+            {
+                this->_storage.resize_uninitialized(storage_size_for(e)); // keeps the allocation and its content
+                this->init_data_view(e);
+                move_rows_in_place(this->_data_ptr, this->byte_stride(), old_stride, keep, pixel_byte_size());
+                fill_outside(keep, fill_value);
+            }
+            else
+            {
+                auto res = empty_like();
+                res.resize_uninitialized(e);
+                copy_rows(res._data_ptr, res.byte_stride(), this->_data_ptr, old_stride, keep, pixel_byte_size());
+                res.fill_outside(keep, fill_value);
+                *this = cc::move(res);
+            }
+        }
+        else
+        {
+            auto res = empty_like();
+            res.resize(e, fill_value);
+            int64_t count = 1;
+            for (auto d = 0; d < dimensions; ++d)
+                count *= keep[d];
+            for (int64_t i = 0; i < count; ++i)
+            {
+                ipos_t p;
+                auto idx = i;
+                for (auto d = 0; d < dimensions; ++d)
+                {
+                    p[d] = int(idx % keep[d]);
+                    idx /= keep[d];
+                }
+                res.at_unchecked(p) = pixel_t(this->at_unchecked(p));
+            }
+            *this = cc::move(res);
+        }
+    }
+
+    /// the allocator the pixels are allocated from
+    allocator& get_allocator() const { return this->_storage.get_allocator(); }
+
+    /// minimum alignment of the pixel allocation in bytes (at least a cache line by default)
+    size_t alignment() const { return this->_storage.alignment(); }
+    /// sets the minimum alignment of the pixel allocation (a power of two, e.g. 4096 for page-aligned storage)
+    /// NOTE: the pixels are moved into a new allocation if the alignment changes (views are invalidated)
+    void set_alignment(size_t bytes)
+    {
+        this->_storage.set_alignment(bytes);
+        this->init_data_view(this->_extent);
+    }
+
+    /// row pitch alignment in bytes (0 if rows are stored compactly)
+    int row_alignment() const { return _row_alignment; }
+    /// pads each row to a multiple of bytes (e.g. 64 for cache-line aligned rows), 0 stores rows compactly
+    /// bytes must be a multiple of alignof(pixel_t), otherwise pixels in later rows would be misaligned
+    /// rows start at multiples of bytes in memory if the allocation alignment is a multiple of it (see set_alignment)
+    /// padding keeps neighboring rows out of shared cache lines and makes aligned SIMD loads possible
+    /// NOTE: the content is preserved (i.e. rows are moved to their new position)
+    void set_row_alignment(int bytes)
+    {
+        static_assert(has_row_padding, "only linear images with a runtime extent can pad their rows");
+        CC_ASSERT(bytes >= 0 && "row alignment cannot be negative");
+        CC_ASSERT(bytes % int(alignof(pixel_t)) == 0 && "row alignment must be a multiple of the pixel alignment");
+        if (bytes == _row_alignment)
+            return;
+        if (this->_data_ptr == nullptr)
+        {
+            _row_alignment = bytes;
+            return;
+        }
+
+        // relayout like resize_preserving (rows are moved in place if the new layout fits into the capacity)
+        auto const old_stride = this->byte_stride();
+        _row_alignment = bytes;
+        if constexpr (std::is_trivially_copyable_v<pixel_t>)
+        {
+            auto const e = this->_extent;
+            auto const keep = e.to_ivec();
+            if (storage_size_for(e) <= this->_storage.capacity())
+            {
+                this->_storage.resize_uninitialized(storage_size_for(e));
+                this->init_data_view(e);
+                move_rows_in_place(this->_data_ptr, this->byte_stride(), old_stride, keep, pixel_byte_size());
+            }
+            else
+            {
+                auto res = empty_like();
+                res.resize_uninitialized(e);
+                copy_rows(res._data_ptr, res.byte_stride(), this->_data_ptr, old_stride, keep, pixel_byte_size());
+                *this = cc::move(res);
+            }
+        }
+        else
+        {
+            auto res = empty_like();
+            res.resize(this->_extent);
+            image_view<BaseTraits>::from_data(this->_data_ptr, this->_extent, old_stride).copy_to(res);
+            *this = cc::move(res);
+        }
+    }
+
+    /// makes sure that images up to the given extent fit without reallocation (keeps the content)
+    /// NOTE: views into this image are invalidated if the allocation grows
+    void reserve(extent_t e)
+    {
+        this->_storage.reserve(storage_size_for(e));
+        this->init_data_view(this->_extent);
+    }
+
+    /// releases the capacity that is not needed for the current extent (keeps the content)
+    void shrink_to_fit()
+    {
+        this->_storage.shrink_to_fit();
+        this->init_data_view(this->_extent);
+    }
 
     // view
 public:
     image_view<BaseTraits> view() { return *this; }
 
+    /// returns the (mutable) blocks of a block-compressed image in row-major order
+    /// NOTE: this is how block images are written, as their pixels are read-only
+    template <class T = traits>
+    cc::span<typename T::block_t> blocks()
+    {
+        static_assert(T::is_block_based, "only block-based images have blocks");
+        return {this->_storage.data(), this->_storage.size()};
+    }
+
     // helper
 private:
+    void copy_from_image(image const& rhs)
+    {
+        if constexpr (traits::is_block_based)
+        {
+            // block images are read-only views, so the blocks themselves are copied
+            this->_storage = rhs._storage;
+            this->init_data_view(rhs.extent());
+        }
+        else if constexpr (std::is_trivially_copyable_v<pixel_t>)
+        {
+            // reuses the allocation if the size matches
+            adopt_channel_count(rhs);
+            _row_alignment = rhs._row_alignment;
+            resize_uninitialized(rhs.extent());
+            rhs.copy_to(*this);
+        }
+        else
+        {
+            this->_storage = rhs._storage;
+            adopt_channel_count(rhs);
+            _row_alignment = rhs._row_alignment;
+            this->init_data_view(rhs.extent());
+        }
+    }
+
+    /// resizes the image as the target of a full copy
+    /// trivially copyable pixels are left uninitialized, as the copy writes each of them exactly once
+    /// (other pixel types need to be constructed before they can be assigned)
+    void resize_for_copy(extent_t e)
+    {
+        if constexpr (std::is_trivially_copyable_v<pixel_t>)
+            resize_uninitialized(e);
+        else
+            resize(e);
+    }
+
+    /// an empty image with the same allocator, alignment, row alignment and channel count
+    image empty_like() const
+    {
+        image res(this->get_allocator());
+        res._storage.set_alignment(this->_storage.alignment());
+        res._row_alignment = _row_alignment;
+        res.adopt_channel_count(*this);
+        return res;
+    }
+
+    /// bytes per pixel (including all channels for images with a runtime channel count)
+    size_t pixel_byte_size() const
+    {
+        if constexpr (traits::has_dynamic_channels)
+            return this->channel_count() * sizeof(pixel_t);
+        else
+            return sizeof(pixel_t);
+    }
+
+    /// position of the row with index r (along x) inside the given extent
+    static ipos_t row_pos(int64_t r, ivec_t const& extent)
+    {
+        ipos_t p;
+        p[0] = 0;
+        for (auto d = 1; d < dimensions; ++d)
+        {
+            p[d] = int(r % extent[d]);
+            r /= extent[d];
+        }
+        return p;
+    }
+    static int64_t row_count(ivec_t const& extent)
+    {
+        int64_t n = 1;
+        for (auto d = 1; d < dimensions; ++d)
+            n *= extent[d];
+        return n;
+    }
+
+    /// copies the rows of a region of the given extent between two strided linear layouts (compact or with padded rows)
+    static void copy_rows(std::byte* dst, ivec_t const& dst_stride, std::byte const* src, ivec_t const& src_stride, ivec_t const& extent, size_t pixel_bytes)
+    {
+        if (detail::is_any_zero(extent))
+            return;
+        auto const row_bytes = size_t(extent[0]) * pixel_bytes;
+        for (int64_t r = 0; r < row_count(extent); ++r)
+        {
+            auto const p = row_pos(r, extent);
+            std::memcpy(dst + detail::strided_offset(p, dst_stride), src + detail::strided_offset(p, src_stride), row_bytes);
+        }
+    }
+
+    /// same as copy_rows but inside the same allocation
+    /// rows keep their order in memory, so if all rows move in the same direction,
+    /// processing them in that direction never overwrites a row before it was moved
+    /// (if some rows move up and others down, e.g. a 3D image that gets wider but shallower, a temporary is used)
+    static void move_rows_in_place(std::byte* data, ivec_t const& dst_stride, ivec_t const& src_stride, ivec_t const& extent, size_t pixel_bytes)
+    {
+        if (detail::is_any_zero(extent))
+            return;
+
+        auto const rows = row_count(extent);
+        auto const row_bytes = size_t(extent[0]) * pixel_bytes;
+        auto moves_up = false;
+        auto moves_down = false;
+        for (int64_t r = 0; r < rows; ++r)
+        {
+            auto const p = row_pos(r, extent);
+            auto const dst = detail::strided_offset(p, dst_stride);
+            auto const src = detail::strided_offset(p, src_stride);
+            moves_up = moves_up || dst > src;
+            moves_down = moves_down || dst < src;
+        }
+
+        auto const move_row = [&](int64_t r) {
+            auto const p = row_pos(r, extent);
+            std::memmove(data + detail::strided_offset(p, dst_stride), data + detail::strided_offset(p, src_stride), row_bytes);
+        };
+        if (!moves_up)
+        {
+            for (int64_t r = 0; r < rows; ++r)
+                move_row(r);
+        }
+        else if (!moves_down)
+        {
+            for (auto r = rows - 1; r >= 0; --r)
+                move_row(r);
+        }
+        else
+        {
+            auto tmp = cc::array<std::byte>::uninitialized(rows * row_bytes);
+            auto const tmp_stride = detail::natural_stride_for(int(pixel_bytes), extent);
+            copy_rows(tmp.data(), tmp_stride, data, src_stride, extent, pixel_bytes);
+            copy_rows(data, dst_stride, tmp.data(), tmp_stride, extent, pixel_bytes);
+        }
+    }
+
+    /// sets all pixels outside of the region [0, keep) to value (for strided linear images)
+    void fill_outside(ivec_t const& keep, pixel_t const& value)
+    {
+        auto const e = this->_extent.to_ivec();
+        auto const stride = this->byte_stride();
+        int64_t c = 1; // scalars per pixel
+        if constexpr (traits::has_dynamic_channels)
+            c = this->channel_count();
+
+        for (int64_t r = 0; r < row_count(e); ++r)
+        {
+            auto const p = row_pos(r, e);
+            auto is_kept_row = true;
+            for (auto d = 1; d < dimensions; ++d)
+                is_kept_row = is_kept_row && p[d] < keep[d];
+
+            auto const row = reinterpret_cast<pixel_t*>(this->_data_ptr + detail::strided_offset(p, stride));
+            for (auto i = (is_kept_row ? keep[0] : 0) * c; i < e[0] * c; ++i)
+                row[i] = value;
+        }
+    }
+
+    /// number of storage elements for an image of extent e (including row padding)
+    /// (channels instead of pixels for images with a runtime channel count)
+    uint64_t storage_size_for(extent_t const& e) const
+    {
+        if constexpr (has_row_padding)
+        {
+            if (_row_alignment > 0)
+            {
+                auto const bytes = uint64_t(padded_stride_for(e.to_ivec())[1]) * uint64_t(row_count(e.to_ivec()));
+                return (bytes + sizeof(pixel_t) - 1) / sizeof(pixel_t);
+            }
+        }
+
+        if constexpr (traits::has_dynamic_channels)
+        {
+            // e.g. filled(e, value) instead of filled(e, channels, value) would silently create zero-channel pixels
+            CC_ASSERT((this->channel_count() > 0 || detail::is_any_zero(e.to_ivec())) && "image has no channel count");
+            return storage_view_t::storage_size_for(e.to_ivec(), this->channel_count());
+        }
+        else
+            return storage_view_t::storage_size_for(e.to_ivec());
+    }
+
+    /// natural stride, but with the row pitch rounded up to a multiple of the row alignment
+    ivec_t padded_stride_for(ivec_t const& e) const
+    {
+        auto s = ivec_t(storage_view_t::natural_stride_for(e));
+        auto const row_bytes = e[0] * int(sizeof(pixel_t));
+        s[1] = (row_bytes + _row_alignment - 1) / _row_alignment * _row_alignment;
+        for (auto d = 2; d < dimensions; ++d)
+            s[d] = s[d - 1] * e[d - 1];
+        return s;
+    }
+
+    template <class T>
+    void set_channel_count(int channels)
+    {
+        static_assert(T::has_dynamic_channels, "only images with a runtime channel count have a channels parameter");
+        CC_ASSERT(channels > 0 && "images need at least one channel");
+        this->_byte_stride.channels = channels;
+    }
+    template <class ViewT>
+    void adopt_channel_count(ViewT const& v)
+    {
+        if constexpr (traits::has_dynamic_channels)
+            this->_byte_stride.channels = v.channel_count();
+    }
+
     void init_data_view(extent_t e)
     {
-        // TODO: stride for block and z order storage
         this->_extent = e;
-        this->_data_ptr = reinterpret_cast<data_ptr_t>(this->_storage.data.data());
-        this->_byte_stride = detail::natural_stride_for(sizeof(pixel_t), e.to_ivec());
+        this->_data_ptr = reinterpret_cast<data_ptr_t>(this->_storage.data());
+        if constexpr (traits::has_dynamic_channels)
+            this->_byte_stride.bytes = storage_view_t::natural_stride_for(e.to_ivec(), this->channel_count());
+        else if constexpr (has_row_padding)
+            this->_byte_stride = _row_alignment > 0 ? padded_stride_for(e.to_ivec()) : ivec_t(storage_view_t::natural_stride_for(e.to_ivec()));
+        else
+            this->_byte_stride = storage_view_t::natural_stride_for(e.to_ivec());
     }
 
     // members
     // NOTE: only storage because rest in saved in the view
 private:
     storage_t _storage;
+    int _row_alignment = 0; // see set_row_alignment
 };
 
 }
@@ -12,6 +12,9 @@ enum class layout_type : uint8_t
 
     strided_linear = 1,
     z_order = 2,
+    tiled = 3,
+    planar = 4,     // one plane per channel, planes share the byte stride
+    procedural = 5, // no memory, pixels are computed on access
 
     custom = 255
 };
@@ -24,6 +27,8 @@ enum class image_type : uint8_t
     image2D,
     image3D,
     imageCube,
+    image1DArray,
+    image2DArray,
 };
 
 enum class pixel_format : uint8_t
@@ -82,8 +87,20 @@ enum class pixel_format : uint8_t
     // depth stencil formats
     depth32f_stencil8u,
     depth24un_stencil8u,
+
+    // NOTE: new formats are appended to keep the values of serialized formats stable
+
+    // block-compressed formats (single and dual channel)
+    bc4_8un,
+    bc5_8un,
 };
 
+/// true for the sRGB variants of GPU formats (their stored values are sRGB encoded, reads return linear values)
+constexpr bool is_srgb_format(pixel_format f)
+{
+    return f == pixel_format::rgba8un_srgb || f == pixel_format::bc1_8un_srgb || f == pixel_format::bc2_8un_srgb || f == pixel_format::bc3_8un_srgb;
+}
+
 enum class pixel_space : uint8_t
 {
     none = 0,
@@ -120,5 +137,8 @@ struct image_metadata
     // strided linear can have custom strides per dimension
     // NOTE: in bytes!
     tg::ivec4 byte_stride;
+
+    // pixels per tile for tiled layouts (0 otherwise)
+    tg::ivec4 tile_extent;
 };
 }
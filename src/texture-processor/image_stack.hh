@@ -4,26 +4,31 @@
 #include <clean-core/vector.hh>
 
 #include <texture-processor/image.hh>
+#include <texture-processor/shared_image.hh>
 
 namespace tp
 {
 /// An image stack is an array of images of homogeneous type but potentially varying sizes
 /// Famous examples are mip-maps or Gaussian stacks
 ///
+/// The images are shared (see shared_image), so copying a stack or adding an already shared image is O(1)
+///
 /// TODO: is this needed or are spans of images/views sufficient?
 template <class Traits>
 struct image_stack
 {
-    // TODO: const version where image is not readable
-    cc::span<image<Traits> const> images() { return _images; }
+    cc::span<shared_image<Traits> const> images() { return _images; }
 
-    void add(image<Traits> img) { _images.push_back(cc::move(img)); }
+    /// takes ownership of the image (move it in to avoid copying the pixels)
+    void add(image<Traits> img) { _images.push_back(shared_image<Traits>(cc::move(img))); }
+    /// shares the pixels with img (O(1))
+    void add(shared_image<Traits> img) { _images.push_back(cc::move(img)); }
 
     void clear() { _images.clear(); }
 
     size_t size() { return _images.size(); }
 
 private:
-    cc::vector<image<Traits>> _images;
+    cc::vector<shared_image<Traits>> _images;
 };
 }
@@ -1,14 +1,24 @@
 #pragma once
 
+#include <cstring>
+
+#include <clean-core/array.hh>
 #include <clean-core/assert.hh>
 #include <clean-core/utility.hh>
 
 #include <texture-processor/convert.hh>
 #include <texture-processor/detail/accessor.hh>
+#include <texture-processor/detail/channels.hh>
 #include <texture-processor/detail/iterator.hh>
+#include <texture-processor/detail/morton.hh>
+#include <texture-processor/detail/planar.hh>
 #include <texture-processor/detail/predicates.hh>
+#include <texture-processor/detail/tiling.hh>
+#include <texture-processor/detail/transpose.hh>
+#include <texture-processor/execution.hh>
 #include <texture-processor/extents.hh>
 #include <texture-processor/image_metadata.hh>
+#include <texture-processor/selection.hh>
 #include <texture-processor/storage_view.hh>
 #include <texture-processor/traits.hh>
 
@@ -16,6 +26,18 @@
 #include <typed-geometry/detail/operators/ops_pos.hh>
 #include <typed-geometry/detail/operators/ops_vec.hh>
 
+// empty members (e.g. the extent and stride of fixed-size views) take no space
+#if defined(_MSC_VER) && _MSC_VER >= 1929
+#define TP_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#elif defined(__has_cpp_attribute)
+#if __has_cpp_attribute(no_unique_address)
+#define TP_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+#endif
+#ifndef TP_NO_UNIQUE_ADDRESS
+#define TP_NO_UNIQUE_ADDRESS
+#endif
+
 namespace tp
 {
 /**
@@ -34,6 +56,8 @@ struct image_view : detail::accessor<BaseTraits::dimensions, image_view<BaseTrai
     using ivec_t = typename traits::ivec_t;
     using extent_t = typename traits::extent_t;
     using storage_view_t = typename traits::storage_view_t;
+    using stride_t = typename traits::stride_t;
+    using subview_t = image_view<typename traits::subview_base_t>;
     using data_ptr_t = typename storage_view_t::data_ptr_t;
     using accessor_t = detail::accessor<BaseTraits::dimensions, image_view<BaseTraits>>;
 
@@ -41,6 +65,11 @@ struct image_view : detail::accessor<BaseTraits::dimensions, image_view<BaseTrai
     static constexpr int channels = traits::channels;
     static constexpr bool is_mutable = traits::is_writeable;
     static constexpr bool is_readonly = !traits::is_writeable;
+    static constexpr bool has_rows = !std::is_void_v<typename traits::row_iterator_t>;
+    static constexpr bool has_fixed_extent = traits::has_fixed_extent;
+    static constexpr bool has_dynamic_channels = traits::has_dynamic_channels;
+    static constexpr bool is_planar = traits::layout_type == layout_type::planar;
+    static constexpr bool is_procedural = traits::layout_type == layout_type::procedural;
 
     // properties
 public:
@@ -48,15 +77,59 @@ public:
     extent_t const& extent() const { return _extent; }
 
     /// stride used to access storage
-    /// TODO: does this apply to z order?
-    ivec_t const& byte_stride() const { return _byte_stride; }
+    /// NOTE: the interpretation depends on the storage (e.g. for z order it is pixel size and interleaved bits)
+    /// NOTE: fixed-size views have no stride state, their (natural) stride is known at compile time
+    /// NOTE: power-of-two views store their stride as shifts
+    ivec_t byte_stride() const { return _byte_stride; }
 
-    /// returns true if this view has natural stride (contiguous row-by-row)
-    /// TODO: also check storage?
-    bool has_natural_stride() const { return detail::is_natural_stride(_byte_stride, sizeof(pixel_t), _extent.to_ivec()); }
+    /// number of channels per pixel (a runtime value for images with dynamic channels)
+    int channel_count() const
+    {
+        if constexpr (has_dynamic_channels)
+            return _byte_stride.channels;
+        else
+            return channels;
+    }
+
+    /// returns true if this view has natural stride (i.e. is stored compactly, e.g. contiguous row-by-row)
+    bool has_natural_stride() const
+    {
+        if constexpr (has_fixed_extent)
+            return true;
+        else if constexpr (is_procedural)
+            return false; // no memory
+        else if constexpr (has_dynamic_channels)
+            return byte_stride() == storage_view_t::natural_stride_for(_extent.to_ivec(), channel_count());
+        else if constexpr (is_planar)
+            return _byte_stride == storage_view_t::natural_stride_for(_extent.to_ivec()); // includes back-to-back planes
+        else
+            return byte_stride() == storage_view_t::natural_stride_for(_extent.to_ivec());
+    }
+
+    /// returns true if this view repeats pixels along some dimension (zero stride, see broadcasted)
+    bool is_broadcasting() const
+    {
+        if constexpr (has_fixed_extent)
+            return false;
+        else
+            return detail::is_broadcasting(byte_stride(), _extent.to_ivec());
+    }
 
     /// size in bytes (if this were to be stored compactly)
-    size_t byte_size() const { return _extent.pixel_count() * sizeof(pixel_t); }
+    /// NOTE: for broadcasting views, this is the size of the materialized (repeated) pixels
+    /// NOTE: for block-based images, this is the size of the (compressed) blocks
+    /// NOTE: for tiled images, this includes the padding of partial tiles
+    size_t byte_size() const
+    {
+        if constexpr (traits::is_block_based)
+            return storage_view_t::storage_size_for(_extent.to_ivec()) * sizeof(typename traits::block_t);
+        else if constexpr (traits::layout_type == layout_type::tiled)
+            return storage_view_t::storage_size_for(_extent.to_ivec()) * sizeof(pixel_t);
+        else if constexpr (has_dynamic_channels)
+            return _extent.pixel_count() * channel_count() * sizeof(pixel_t);
+        else
+            return _extent.pixel_count() * sizeof(pixel_t);
+    }
 
     /// returns number of pixels
     size_t pixel_count() const { return _extent.pixel_count(); }
@@ -73,7 +146,9 @@ public:
     {
         auto md = traits::make_metadata();
         md.extent = tg::ivec4(_extent.to_ivec(), 1);
-        md.byte_stride = tg::ivec4(_byte_stride);
+        md.byte_stride = tg::ivec4(byte_stride());
+        if constexpr (has_dynamic_channels)
+            md.channels = channel_count();
         return md;
     }
 
@@ -101,28 +176,92 @@ public:
     // TODO: how to change between different types?
 public:
     /// returns a subview that contains all pixels by start and extent
-    [[nodiscard]] image_view subview(ipos_t start, extent_t extent) const
+    /// NOTE: z order views only support subviews that are aligned to a power of two at least as large as their extent
+    /// NOTE: block-based views only support subviews that start at block boundaries
+    /// NOTE: tiled views only support subviews that start at tile boundaries
+    /// NOTE: subviews of fixed-size views are regular (dynamically sized) views
+    [[nodiscard]] subview_t subview(ipos_t start, typename subview_t::extent_t extent) const
     {
         CC_ASSERT((detail::is_any_zero(extent.to_ivec()) || contains(start)) && "subview out of bounds");
         CC_ASSERT((detail::is_any_zero(extent.to_ivec()) || contains(start + extent.to_ivec() - 1)) && "subview out of bounds");
-        image_view v;
-        v._data_ptr = _data_ptr + detail::strided_offset(start, _byte_stride);
+        if constexpr (traits::layout_type == layout_type::z_order)
+            CC_ASSERT(detail::is_morton_aligned(start.x, start.y, extent.width, extent.height) && "z order subviews must be aligned");
+        if constexpr (traits::is_block_based)
+            CC_ASSERT(start.x % storage_view_t::block_width == 0 && start.y % storage_view_t::block_height == 0 && "block subviews must be block-aligned");
+        if constexpr (traits::layout_type == layout_type::tiled)
+            for (auto d = 0; d < dimensions; ++d)
+                CC_ASSERT(start[d] % storage_view_t::tile_sizes[d] == 0 && "tiled subviews must be tile-aligned");
+        subview_t v;
+        v._data_ptr = _data_ptr + storage_view_t::byte_offset(start, _byte_stride);
         v._extent = extent;
         v._byte_stride = _byte_stride;
+        if constexpr (is_procedural)
+            v._byte_stride.origin = v._byte_stride.origin + ivec_t(start);
         return v;
     }
-    [[nodiscard]] image_view subview(tg::aabb<dimensions, int> const& bb) const
+    [[nodiscard]] subview_t subview(tg::aabb<dimensions, int> const& bb) const
     {
-        return this->subview(bb.min, extent_t::from_ivec(bb.max - bb.min + 1));
+        return this->subview(bb.min, subview_t::extent_t::from_ivec(bb.max - bb.min + 1));
+    }
+
+    /// returns a read-only view onto the same pixels (this view if it is already read-only)
+    /// the view has the same layout and extent type (e.g. tiled or fixed-size views stay tiled or fixed-size)
+    [[nodiscard]] auto readonly() const
+    {
+        if constexpr (is_readonly)
+            return *this;
+        else
+        {
+            using view_t = image_view<typename traits::const_traits>;
+            static_assert(!std::is_void_v<typename traits::const_traits>, "image type does not support read-only views");
+            view_t v;
+            v._data_ptr = _data_ptr;
+            v._extent = view_t::extent_t::from_ivec(_extent.to_ivec());
+            if constexpr (std::is_same_v<stride_t, typename view_t::stride_t>)
+                v._byte_stride = _byte_stride;
+            else
+                v._byte_stride = byte_stride();
+            return v;
+        }
+    }
+
+    /// returns a view onto a single channel of each pixel (e.g. the green component of an rgb image)
+    /// the view aliases this one (no copy), so writes are visible in the original pixels
+    /// NOTE: only strided linear views with tightly packed channels (e.g. tg::color3, tg::vec4) are supported
+    /// NOTE: for planar views, this is the (contiguous) plane of the channel
+    /// usage:
+    ///    auto green = rgb_image.channel(1); // image2_view<float>
+    ///    green.fill(0.f);
+    [[nodiscard]] auto channel(int c) const
+    {
+        CC_ASSERT(0 <= c && c < channels && "channel out of bounds");
+        if constexpr (is_planar)
+        {
+            using view_t = image_view<typename traits::plane_base_t>;
+            return view_t::from_data(_data_ptr + c * _byte_stride.plane_bytes, view_t::extent_t::from_ivec(_extent.to_ivec()), byte_stride());
+        }
+        else
+            return this->template component_view<scalar_t>(c);
+    }
+    /// returns a view onto Count consecutive channels of each pixel, starting at channel First
+    /// (pixels are tg::comp<Count, scalar> or the scalar type if Count is 1)
+    /// usage:
+    ///    auto rg = rgba_image.channel_range<0, 2>(); // image2_view<tg::comp<2, float>>
+    template <int First, int Count = 1>
+    [[nodiscard]] auto channel_range() const
+    {
+        static_assert(0 <= First && Count >= 1 && First + Count <= channels, "channel range out of bounds");
+        return this->template component_view<std::conditional_t<Count == 1, scalar_t, tg::comp<Count, scalar_t>>>(First);
     }
 
     /// returns an image view where the dimension D is mirrored
     /// NOTE: there are also non-templated versions like mirrored_x()
-    /// TODO: static assert when storage does not allow this operation
     template <int D>
     [[nodiscard]] image_view mirrored() const
     {
         static_assert(0 <= D && D < dimensions, "invalid dimension");
+        static_assert(storage_view_t::is_strided_linear || has_dynamic_channels || is_planar, "mirroring is only supported for strided linear storage");
+        static_assert(traits::has_arbitrary_stride, "fixed-size and power-of-two views cannot be mirrored, mirror a subview instead");
         auto ev = _extent.to_ivec();
         image_view v = *this; // copy
         if (ev[D] != 0)
@@ -133,16 +272,62 @@ public:
         return v;
     }
 
+    /// returns a read-only view where dimension D (which must have extent 1) is repeated n times
+    /// no memory is touched, the stride of D is set to zero
+    /// NOTE: there are also non-templated versions like broadcasted_y(n)
+    /// usage:
+    ///    // apply a per-column factor (vignetting) without materializing it
+    ///    auto factors = image2_view<float const>::from_data(data, {w, 1}, {4, 4 * w});
+    ///    img.for_each([&, f = factors.broadcasted_y(img.height())](tg::ipos2 p, tg::color3& c) { c *= f(p); });
+    template <int D>
+    [[nodiscard]] image_view<typename traits::const_traits> broadcasted(int n) const
+    {
+        static_assert(0 <= D && D < dimensions, "invalid dimension");
+        static_assert(storage_view_t::is_strided_linear || has_dynamic_channels || is_planar, "broadcasting is only supported for strided linear storage");
+        static_assert(traits::has_arbitrary_stride, "fixed-size and power-of-two views cannot be broadcast, broadcast a subview instead");
+        CC_ASSERT(_extent.to_ivec()[D] == 1 && "only dimensions of extent 1 can be broadcast");
+        CC_ASSERT(n >= 0);
+        auto ev = _extent.to_ivec();
+        ev[D] = n;
+        image_view<typename traits::const_traits> v;
+        v._data_ptr = _data_ptr;
+        v._byte_stride = _byte_stride;
+        v._byte_stride[D] = 0;
+        v._extent = extent_t::from_ivec(ev);
+        return v;
+    }
+    /// returns a read-only view of the given extent, where all dimensions of extent 1 are repeated as needed
+    /// (all other dimensions must match)
+    [[nodiscard]] image_view<typename traits::const_traits> broadcasted(extent_t const& extent) const
+    {
+        static_assert(storage_view_t::is_strided_linear || has_dynamic_channels || is_planar, "broadcasting is only supported for strided linear storage");
+        static_assert(traits::has_arbitrary_stride, "fixed-size and power-of-two views cannot be broadcast, broadcast a subview instead");
+        auto const e = _extent.to_ivec();
+        auto const te = extent.to_ivec();
+        image_view<typename traits::const_traits> v;
+        v._data_ptr = _data_ptr;
+        v._byte_stride = _byte_stride;
+        v._extent = extent;
+        for (auto d = 0; d < dimensions; ++d)
+        {
+            CC_ASSERT((e[d] == te[d] || e[d] == 1) && "extent cannot be broadcast");
+            if (e[d] != te[d])
+                v._byte_stride[d] = 0;
+        }
+        return v;
+    }
+
     /// returns an image view where the dimensions D0 and D1 are swapped
     /// (D0 == D1 is ok and returns this)
     /// NOTE: some image types have restrictions on which dimensions to swap (e.g. #faces in a cubemap)
     /// NOTE: there are also non-templated versions like swapped_xy()
-    /// TODO: static assert when storage does not allow this operation
     template <int D0, int D1>
     [[nodiscard]] image_view swapped() const
     {
         static_assert(0 <= D0 && D0 < dimensions, "invalid dimension");
         static_assert(0 <= D1 && D1 < dimensions, "invalid dimension");
+        static_assert(storage_view_t::is_strided_linear || has_dynamic_channels || is_planar, "swapping is only supported for strided linear storage");
+        static_assert(traits::has_arbitrary_stride, "fixed-size and power-of-two views cannot be swapped, swap a subview instead");
         if constexpr (D0 == D1)
             return *this;
         else
@@ -194,30 +379,148 @@ public:
     ///        v = tg::color3::red;
     auto pixels() const -> detail::srange<typename traits::pixel_iterator_t> { return {{_data_ptr, _byte_stride, _extent.to_ivec()}}; }
 
+    /// returns an iterable range that visits all rows (runs along the dimension with smallest stride) in memory order
+    /// each row is a pixel_run which can be converted to a cc::span<pixel_t> if contiguous
+    /// NOTE: only available for strided linear and tiled storage (where rows are the parts of rows inside a tile)
+    /// usage:
+    ///    for (auto const& r : my_image2.rows())
+    ///        for (auto i = 0; i < r.size; ++i)
+    ///            r[i] = f(r.pos_at(i));
+    auto rows() const -> detail::srange<typename traits::row_iterator_t>
+    {
+        static_assert(has_rows, "rows are only supported for strided linear and tiled storage");
+        return {{_data_ptr, _byte_stride, _extent.to_ivec()}};
+    }
+
     /// iterates over the image (in an optimized order)
     /// calls F for each pixel position
     /// signature: (ipos_t) -> void OR
     ///            (ipos_t, pixel_access_t) -> void
     template <class F>
-    void for_each(F&& f)
+    void for_each(F&& f) const
     {
-        for (auto p : this->positions())
-            if constexpr (std::is_invocable_v<F, ipos_t>)
+        if constexpr (std::is_invocable_v<F, ipos_t>)
+        {
+            for (auto p : this->positions())
                 f(p);
-            else if constexpr (std::is_invocable_v<F, ipos_t, pixel_access_t>)
-                f(p, at_unchecked(p));
+        }
+        else if constexpr (std::is_invocable_v<F, ipos_t, pixel_access_t>)
+        {
+            if constexpr (has_fixed_extent)
+            {
+                // compile-time bounds, the loops can be fully unrolled or vectorized
+                auto const d = reinterpret_cast<pixel_t*>(_data_ptr);
+                detail::for_each_fixed_index<extent_t>([&](ipos_t const& p, int64_t i) { f(p, d[i]); });
+            }
+            else if constexpr (has_rows)
+            {
+                for (auto const& r : this->rows())
+                {
+                    auto p = r.pos;
+                    if (r.is_contiguous())
+                    {
+                        auto d = r.span().data();
+                        for (auto i = 0; i < r.size; ++i, p[r.dim] += r.pos_step)
+                            f(p, d[i]);
+                    }
+                    else
+                    {
+                        for (auto i = 0; i < r.size; ++i, p[r.dim] += r.pos_step)
+                            f(p, r[i]);
+                    }
+                }
+            }
+            else
+            {
+                for (auto&& [p, v] : *this)
+                    f(p, v);
+            }
+        }
+        else
+            static_assert(cc::always_false<F>, "function must be callable with ipos_t or (ipos_t, pixel_access_t)");
+    }
+    /// same as for_each(f) but with an explicit execution policy
+    /// NOTE: with tp::par, f is called concurrently from multiple threads
+    template <class F>
+    void for_each(sequenced_policy, F&& f) const
+    {
+        this->for_each(f);
+    }
+    template <class F>
+    void for_each(parallel_policy const& policy, F&& f) const
+    {
+        detail::for_each_tile(policy, *this, [&f](ipos_t const& start, auto const& tile) {
+            if constexpr (std::is_invocable_v<F, ipos_t>)
+                tile.for_each([&f, start](ipos_t const& p) { f(start + tg::vec<dimensions, int>(p)); });
             else
-                static_assert(cc::always_false<F>, "function must be callable with ipos_t or (ipos_t, pixel_access_t)");
+                tile.for_each([&f, start](ipos_t const& p, pixel_access_t v) { f(start + tg::vec<dimensions, int>(p), v); });
+        });
     }
 
     // modification
 public:
     /// overwrites all pixels with the given value
-    void fill(pixel_t const& value)
+    void fill(pixel_t const& value) const
+    {
+        static_assert(is_mutable, "cannot write to this image");
+        if constexpr (has_fixed_extent)
+        {
+            auto const d = reinterpret_cast<pixel_t*>(_data_ptr);
+            for (uint64_t i = 0; i < extent_t::pixel_count(); ++i)
+                d[i] = value;
+        }
+        else if constexpr (has_rows)
+        {
+            // positions don't matter, so contiguous rows (or full tiles) can be merged into flat loops
+            for (auto const& r : detail::srange<typename traits::row_iterator_t>({_data_ptr, _byte_stride, _extent.to_ivec(), true /* merge rows */}))
+            {
+                if (r.is_contiguous())
+                    for (auto& p : r.span())
+                        p = value;
+                else
+                    for (auto i = 0; i < r.size; ++i)
+                        r[i] = value;
+            }
+        }
+        else if constexpr (has_dynamic_channels)
+        {
+            // every channel is set to value
+            auto const c = channel_count();
+            for (auto const& r : this->channel_rows(true /* merge rows */))
+            {
+                if (r.byte_stride == c * int(sizeof(pixel_t)))
+                {
+                    auto const d = reinterpret_cast<pixel_t*>(r.data);
+                    for (int64_t i = 0; i < int64_t(r.size) * c; ++i)
+                        d[i] = value;
+                }
+                else
+                    for (auto i = 0; i < r.size; ++i)
+                    {
+                        auto const d = reinterpret_cast<pixel_t*>(r.data + int64_t(i) * r.byte_stride);
+                        for (auto k = 0; k < c; ++k)
+                            d[k] = value;
+                    }
+            }
+        }
+        else if constexpr (is_planar)
+        {
+            // each plane is a scalar image
+            for (auto c = 0; c < channels; ++c)
+                this->channel(c).fill(value[c]);
+        }
+        else
+        {
+            for (auto&& p : this->pixels())
+                p = value;
+        }
+    }
+    /// same as fill(value) but with an explicit execution policy
+    void fill(sequenced_policy, pixel_t const& value) const { this->fill(value); }
+    void fill(parallel_policy const& policy, pixel_t const& value) const
     {
         static_assert(is_mutable, "cannot write to this image");
-        for (auto& p : pixels())
-            p = value;
+        detail::for_each_tile(policy, *this, [&value](ipos_t const&, auto const& tile) { tile.fill(value); });
     }
 
     // copying
@@ -227,44 +530,827 @@ public:
     ///       converter can be used to customize behavior when changing pixel types
     ///       signature: (src_pixel const&) -> target_pixel OR
     ///                  (target_pixel&, src_pixel cont&) -> void
-    /// TODO: performance speedup via detecting cases where memcpy works
-    ///       performance speedup via block copy when strides mismatch
+    ///       if source and target overlap in memory, the copy behaves as if a temporary was used (like memmove)
+    ///       this is supported for all layouts, but requires trivially copyable pixels (asserted)
+    ///       images with a runtime channel count must not overlap unless both are compact
+    /// NOTE: same-type copies of trivially copyable pixels are done via a single memcpy (natural strides on both sides)
+    ///       or a memcpy per row (when only the row pitches differ)
+    ///       if source and target disagree on their innermost dimension (e.g. src is a swapped or rotated view),
+    ///       a cache-blocked transpose is used instead
     template <class RhsTraits, class ConverterT = default_converter>
     void copy_to(image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
     {
-        static_assert(rhs.is_mutable, "cannot copy into immutable view");
-        static_assert(dimensions == rhs.dimensions, "dimensions must match for copy");
+        using rhs_view_t = image_view<RhsTraits>;
+        using rhs_pixel_t = typename rhs_view_t::pixel_t;
+        static_assert(rhs_view_t::is_mutable, "cannot copy into immutable view");
+        static_assert(dimensions == rhs_view_t::dimensions, "dimensions must match for copy");
         CC_ASSERT(_extent.to_ivec() == rhs.extent().to_ivec() && "extents must match for copy"); // TODO: log an error with extents WITHOUT including string or format
 
-        for (auto p : this->positions())
+        // overlapping copies between other layouts go through a compact temporary
+        // (strided linear copies handle overlap below, as do compact images with a runtime channel count)
+        constexpr bool is_linear_copy = storage_view_t::is_strided_linear && rhs_view_t::storage_view_t::is_strided_linear;
+        if constexpr (!is_procedural && !rhs_view_t::is_procedural && !has_dynamic_channels && !rhs_view_t::has_dynamic_channels && !is_linear_copy)
+        {
+            if (this->is_overlapping_with(rhs))
+            {
+                constexpr bool is_trivial_pixel = std::is_trivially_copyable_v<std::remove_const_t<pixel_t>>;
+                CC_ASSERT(is_trivial_pixel && "overlapping copies are only supported for trivially copyable pixels");
+                if constexpr (is_trivial_pixel)
+                {
+                    this->copy_through_temporary(rhs, convert);
+                    return;
+                }
+            }
+        }
+
+        if constexpr (has_dynamic_channels && rhs_view_t::has_dynamic_channels)
         {
-            if constexpr (std::is_invocable_r_v<typename image_view<RhsTraits>::pixel_t, ConverterT, pixel_t const&>)
-                rhs.at_unchecked(p) = convert(at_unchecked(p));
-            else if constexpr (std::is_invocable_v<ConverterT, typename image_view<RhsTraits>::pixel_access_t, pixel_t const&>)
-                convert(rhs.at_unchecked(p), at_unchecked(p));
+            // channels are copied (and converted) individually, kernels are specialized for 1 to 4 channels
+            auto const c = channel_count();
+            CC_ASSERT(c == rhs.channel_count() && "channel counts must match for copy");
+            constexpr bool is_memcpy_compatible = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                                  && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+            if constexpr (is_memcpy_compatible)
+            {
+                if (has_natural_stride() && rhs.has_natural_stride())
+                {
+                    std::memmove(rhs.data_ptr(), _data_ptr, byte_size());
+                    return;
+                }
+            }
+            CC_ASSERT(!detail::is_overlapping<dimensions>(_data_ptr, byte_stride(), c * sizeof(pixel_t), rhs.data_ptr(), rhs.byte_stride(),
+                                                          c * sizeof(rhs_pixel_t), _extent.to_ivec())
+                      && "overlapping copies of images with a runtime channel count are not supported");
+
+            auto const rhs_stride = rhs.byte_stride();
+            detail::dispatch_channel_count(c, [&](auto n) {
+                constexpr int N = decltype(n)::value;
+                for (auto const& r : this->channel_rows(false))
+                    detail::copy_channel_run<N, rhs_pixel_t, std::remove_const_t<pixel_t>>(rhs.data_ptr() + detail::strided_offset(r.pos, rhs_stride),
+                                                                                           int64_t(rhs_stride[r.dim]) * r.pos_step, r.data,
+                                                                                           r.byte_stride, r.size, c, convert);
+            });
+        }
+        else if constexpr (has_dynamic_channels || rhs_view_t::has_dynamic_channels)
+        {
+            static_assert(cc::always_false<RhsTraits>, "images with a runtime channel count can only be copied to each other");
+        }
+        else if constexpr (is_procedural && rhs_view_t::has_rows)
+        {
+            // pixels are generated directly in the memory order of the target
+            for (auto const& r : rhs.rows())
+                for (auto i = 0; i < r.size; ++i)
+                    detail::apply_converter(convert, r[i], storage_view_t::value_at(r.pos_at(i), _byte_stride));
+        }
+        else if constexpr (rhs_view_t::is_procedural)
+        {
+            // every pixel is passed to the setter
+            using rhs_storage_view_t = typename rhs_view_t::storage_view_t;
+            for (auto p : this->positions())
+            {
+                std::remove_const_t<pixel_t> const src = this->at_unchecked(p);
+                rhs_pixel_t dst;
+                detail::apply_converter(convert, dst, src);
+                rhs_storage_view_t::pixel_at(nullptr, p, rhs._byte_stride) = dst;
+            }
+        }
+        else if constexpr (is_planar || rhs_view_t::is_planar)
+        {
+            // same-type copies are plane-wise or (de)interleaving runs, see detail/planar.hh
+            constexpr bool is_plain_copy = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                           && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            if constexpr (is_plain_copy && is_planar && rhs_view_t::is_planar)
+            {
+                for (auto c = 0; c < channels; ++c)
+                    this->channel(c).copy_to(rhs.channel(c));
+            }
+            else if constexpr (is_plain_copy && storage_view_t::is_strided_linear)
+            {
+                // deinterleave along the source rows
+                auto const rhs_stride = rhs._byte_stride;
+                for (auto const& r : this->rows())
+                    detail::deinterleave_run<channels, scalar_t>(r.data, r.byte_stride, rhs.data_ptr() + detail::strided_offset(r.pos, rhs_stride.bytes),
+                                                                 int64_t(rhs_stride.bytes[r.dim]) * r.pos_step, rhs_stride.plane_bytes, r.size);
+            }
+            else if constexpr (is_plain_copy && rhs_view_t::storage_view_t::is_strided_linear)
+            {
+                // interleave along the target rows
+                for (auto const& r : rhs.rows())
+                    detail::interleave_run<channels, scalar_t>(_data_ptr + detail::strided_offset(r.pos, _byte_stride.bytes),
+                                                               int64_t(_byte_stride.bytes[r.dim]) * r.pos_step, _byte_stride.plane_bytes, r.data,
+                                                               r.byte_stride, r.size);
+            }
             else
-                static_assert(cc::always_false<RhsTraits, ConverterT>, "no suitable call syntax found for converter");
+            {
+                // planar pixels are proxies, conversion happens on temporaries
+                for (auto p : this->positions())
+                {
+                    std::remove_const_t<pixel_t> const src = this->at_unchecked(p);
+                    rhs_pixel_t dst;
+                    detail::apply_converter(convert, dst, src);
+                    rhs.at_unchecked(p) = dst;
+                }
+            }
+        }
+        else if constexpr (storage_view_t::is_strided_linear && rhs_view_t::storage_view_t::is_strided_linear)
+        {
+            constexpr bool is_same_pixel = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t>;
+            constexpr bool is_trivial_pixel = is_same_pixel && std::is_trivially_copyable_v<rhs_pixel_t>;
+            constexpr bool is_memcpy_compatible = is_trivial_pixel && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            // single memmove for fully compact images (also handles overlap)
+            if constexpr (is_memcpy_compatible)
+            {
+                if (has_natural_stride() && rhs.has_natural_stride())
+                {
+                    std::memmove(rhs.data_ptr(), _data_ptr, byte_size());
+                    return;
+                }
+            }
+
+            // other overlapping copies go through a compact temporary
+            if constexpr (is_same_pixel)
+            {
+                auto const is_overlapping = detail::is_overlapping<dimensions>(_data_ptr, _byte_stride, sizeof(pixel_t), rhs.data_ptr(),
+                                                                               rhs.byte_stride(), sizeof(rhs_pixel_t), _extent.to_ivec());
+                CC_ASSERT((is_trivial_pixel || !is_overlapping) && "overlapping copies are only supported for trivially copyable pixels");
+                if (is_trivial_pixel && is_overlapping)
+                {
+                    auto tmp_data = cc::array<std::byte>::uninitialized(byte_size());
+                    auto tmp = rhs_view_t::from_data(tmp_data.data(), rhs.extent(), detail::natural_stride_for(sizeof(rhs_pixel_t), _extent.to_ivec()));
+                    this->copy_to(tmp);
+                    tmp.copy_to(rhs, convert);
+                    return;
+                }
+            }
+
+            // fixed-size source and target are both compact, i.e. a flat loop with a compile-time trip count
+            if constexpr (has_fixed_extent && rhs_view_t::has_fixed_extent)
+            {
+                auto const src = reinterpret_cast<pixel_t*>(_data_ptr);
+                auto const dst = reinterpret_cast<rhs_pixel_t*>(rhs.data_ptr());
+                for (uint64_t i = 0; i < extent_t::pixel_count(); ++i)
+                    detail::apply_converter(convert, dst[i], src[i]);
+                return;
+            }
+
+            auto const rhs_stride = rhs.byte_stride();
+
+            // broadcasting sources are traversed in target order, zero-stride runs are loaded and converted once
+            // and runs that repeat the previous source run are copied from the previous target run
+            if constexpr (traits::has_arbitrary_stride)
+            {
+                if (is_broadcasting())
+                {
+                    CC_ASSERT(!rhs.is_broadcasting() && "cannot copy into broadcasting views");
+                    std::byte const* prev_src = nullptr;
+                    typename rhs_view_t::data_ptr_t prev_dst = nullptr;
+                    for (auto const& r : rhs.rows())
+                    {
+                        std::byte const* src = _data_ptr + detail::strided_offset(r.pos, _byte_stride);
+                        auto const src_step = int64_t(_byte_stride[r.dim]) * r.pos_step;
+                        if (src_step == 0)
+                        {
+                            rhs_pixel_t v;
+                            detail::apply_converter(convert, v, *reinterpret_cast<pixel_t const*>(src));
+                            for (auto i = 0; i < r.size; ++i)
+                                r[i] = v;
+                            continue;
+                        }
+
+                        if constexpr (std::is_trivially_copyable_v<rhs_pixel_t>)
+                        {
+                            if (src == prev_src && r.is_contiguous())
+                            {
+                                std::memcpy(r.data, prev_dst, size_t(r.size) * sizeof(rhs_pixel_t));
+                                continue;
+                            }
+                            if (r.is_contiguous())
+                            {
+                                prev_src = src;
+                                prev_dst = r.data;
+                            }
+                        }
+
+                        for (auto i = 0; i < r.size; ++i, src += src_step)
+                            detail::apply_converter(convert, r[i], *reinterpret_cast<pixel_t const*>(src));
+                    }
+                    return;
+                }
+            }
+
+            // blocked transpose if the innermost dimensions of source and target disagree
+            if constexpr (is_memcpy_compatible && dimensions >= 2)
+            {
+                auto const e = _extent.to_ivec();
+                auto const a = detail::innermost_dimension(byte_stride());
+                auto const b = detail::innermost_dimension(rhs_stride);
+                if (a != b && e[a] > 1 && e[b] > 1 && !detail::is_any_zero(e)) // the outer loop visits at least one slice
+                {
+                    // all remaining dimensions are iterated in the outer loop
+                    ipos_t p;
+                    while (true)
+                    {
+                        detail::blocked_transpose_copy<rhs_pixel_t>(_data_ptr + detail::strided_offset(p, _byte_stride), _byte_stride[a], _byte_stride[b],
+                                                                    rhs.data_ptr() + detail::strided_offset(p, rhs_stride), rhs_stride[a], rhs_stride[b],
+                                                                    e[a], e[b]);
+
+                        auto d = 0;
+                        for (; d < dimensions; ++d)
+                        {
+                            if (d == a || d == b)
+                                continue;
+                            if (++p[d] < e[d])
+                                break;
+                            p[d] = 0;
+                        }
+                        if (d == dimensions)
+                            return;
+                    }
+                }
+            }
+
+            // row-wise traversal of the source, target is addressed via incrementally updated pointer
+            for (auto const& r : this->rows())
+            {
+                auto const dst_stride = int64_t(rhs_stride[r.dim]) * r.pos_step;
+                auto dst = rhs.data_ptr() + detail::strided_offset(r.pos, rhs_stride);
+
+                if constexpr (is_memcpy_compatible)
+                {
+                    if (r.is_contiguous() && dst_stride == r.byte_stride)
+                    {
+                        std::memcpy(dst, r.data, size_t(r.size) * sizeof(pixel_t));
+                        continue;
+                    }
+                }
+
+                for (auto i = 0; i < r.size; ++i, dst += dst_stride)
+                    detail::apply_converter(convert, *reinterpret_cast<rhs_pixel_t*>(dst), r[i]);
+            }
+        }
+        else if constexpr (RhsTraits::layout_type == layout_type::tiled && (storage_view_t::is_strided_linear || traits::layout_type == layout_type::tiled))
+        {
+            constexpr bool is_memcpy_compatible = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                                  && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            // identical tilings without partial tiles are a single memmove
+            // NOTE: partial tiles are padding here but may be pixels of a larger parent image on the target side
+            if constexpr (is_memcpy_compatible && traits::layout_type == layout_type::tiled)
+            {
+                using rhs_storage_view_t = typename rhs_view_t::storage_view_t;
+                constexpr bool is_same_tiling = storage_view_t::tile_sizes[0] == rhs_storage_view_t::tile_sizes[0]
+                                                && storage_view_t::tile_sizes[1] == rhs_storage_view_t::tile_sizes[1]
+                                                && storage_view_t::tile_sizes[2] == rhs_storage_view_t::tile_sizes[2];
+                if constexpr (is_same_tiling)
+                {
+                    auto const e = _extent.to_ivec();
+                    if (has_natural_stride() && rhs.has_natural_stride() && storage_view_t::storage_size_for(e) == uint64_t(pixel_count()))
+                    {
+                        std::memmove(rhs.data_ptr(), _data_ptr, byte_size());
+                        return;
+                    }
+                }
+            }
+
+            // target tile rows are contiguous, the source is read along x (split at source tile boundaries)
+            for (auto const& r : rhs.rows())
+            {
+                auto i = 0;
+                while (i < r.size)
+                {
+                    auto const p = r.pos_at(i);
+                    auto const src = _data_ptr + storage_view_t::byte_offset(p, _byte_stride);
+                    auto n = r.size - i;
+                    int64_t src_step = sizeof(pixel_t);
+                    if constexpr (storage_view_t::is_strided_linear)
+                        src_step = _byte_stride[0];
+                    else
+                    {
+                        constexpr auto tw = storage_view_t::tile_sizes[0];
+                        n = n < tw - (p.x & (tw - 1)) ? n : tw - (p.x & (tw - 1));
+                    }
+
+                    if constexpr (is_memcpy_compatible)
+                    {
+                        if (src_step == int64_t(sizeof(pixel_t)))
+                        {
+                            std::memcpy(&r[i], src, size_t(n) * sizeof(pixel_t));
+                            i += n;
+                            continue;
+                        }
+                    }
+
+                    for (auto k = 0; k < n; ++k)
+                        detail::apply_converter(convert, r[i + k], *reinterpret_cast<pixel_t*>(src + k * src_step));
+                    i += n;
+                }
+            }
+        }
+        else if constexpr (traits::layout_type == layout_type::tiled && rhs_view_t::storage_view_t::is_strided_linear)
+        {
+            constexpr bool is_memcpy_compatible = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                                  && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            // source tile rows are contiguous, the target is written along x
+            auto const rhs_stride = rhs.byte_stride();
+            for (auto const& r : this->rows())
+            {
+                auto dst = rhs.data_ptr() + detail::strided_offset(r.pos, rhs_stride);
+
+                if constexpr (is_memcpy_compatible)
+                {
+                    if (rhs_stride.x == int(sizeof(pixel_t)))
+                    {
+                        std::memcpy(dst, r.data, size_t(r.size) * sizeof(pixel_t));
+                        continue;
+                    }
+                }
+
+                for (auto i = 0; i < r.size; ++i, dst += rhs_stride.x)
+                    detail::apply_converter(convert, *reinterpret_cast<rhs_pixel_t*>(dst), r[i]);
+            }
+        }
+        else if constexpr (traits::layout_type == layout_type::z_order && RhsTraits::layout_type == layout_type::z_order)
+        {
+            constexpr bool is_memcpy_compatible = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                                  && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            // identical layouts without padding are a single memmove
+            if constexpr (is_memcpy_compatible)
+            {
+                auto const e = _extent.to_ivec();
+                if (has_natural_stride() && rhs.has_natural_stride() && storage_view_t::storage_size_for(e) == uint64_t(pixel_count()))
+                {
+                    std::memmove(rhs.data_ptr(), _data_ptr, byte_size());
+                    return;
+                }
+            }
+
+            // otherwise both sides are traversed in the same Z-order
+            if (_byte_stride.y == rhs.byte_stride().y)
+            {
+                auto dst = typename rhs_view_t::traits::pixel_iterator_t(rhs.data_ptr(), rhs.byte_stride(), rhs.extent().to_ivec());
+                for (auto&& v : this->pixels())
+                {
+                    detail::apply_converter(convert, *dst, v);
+                    ++dst;
+                }
+            }
+            else
+            {
+                for (auto&& [p, v] : *this)
+                    detail::apply_converter(convert, rhs.at_unchecked(p), v);
+            }
+        }
+        else if constexpr (traits::is_block_based)
+        {
+            // decode whole blocks at once
+            constexpr auto bw = storage_view_t::block_width;
+            constexpr auto bh = storage_view_t::block_height;
+            constexpr bool is_direct_store = rhs_view_t::storage_view_t::is_strided_linear && std::is_same_v<rhs_pixel_t, tg::color4>
+                                             && std::is_same_v<std::decay_t<ConverterT>, default_converter>;
+
+            auto const e = _extent.to_ivec();
+            tg::color4 decoded[bw * bh];
+            for (auto by = 0; by < e.y; by += bh)
+                for (auto bx = 0; bx < e.x; bx += bw)
+                {
+                    storage_view_t::block_at(_data_ptr, {bx, by}, _byte_stride).decode(decoded);
+
+                    auto const w = e.x - bx < bw ? e.x - bx : bw;
+                    auto const h = e.y - by < bh ? e.y - by : bh;
+                    for (auto y = 0; y < h; ++y)
+                    {
+                        if constexpr (is_direct_store)
+                        {
+                            if (rhs.byte_stride().x == int(sizeof(tg::color4)))
+                            {
+                                std::memcpy(&rhs.at_unchecked({bx, by + y}), decoded + y * bw, w * sizeof(tg::color4));
+                                continue;
+                            }
+                        }
+
+                        for (auto x = 0; x < w; ++x)
+                            detail::apply_converter(convert, rhs.at_unchecked({bx + x, by + y}), decoded[y * bw + x]);
+                    }
+                }
+        }
+        else if constexpr (storage_view_t::is_strided_linear)
+        {
+            for (auto const& r : this->rows())
+                for (auto i = 0; i < r.size; ++i)
+                    detail::apply_converter(convert, rhs.at_unchecked(r.pos_at(i)), r[i]);
+        }
+        else
+        {
+            // traversal in the memory order of the source
+            for (auto&& [p, v] : *this)
+                detail::apply_converter(convert, rhs.at_unchecked(p), v);
         }
     }
+    /// same as copy_to(rhs, convert) but with an explicit execution policy
+    /// NOTE: with tp::par, convert is called concurrently from multiple threads
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_to(sequenced_policy, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        this->copy_to(rhs, convert);
+    }
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_to(parallel_policy const& policy, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        static_assert(dimensions == image_view<RhsTraits>::dimensions, "dimensions must match for copy");
+        CC_ASSERT(_extent.to_ivec() == rhs.extent().to_ivec() && "extents must match for copy");
+
+        // overlapping copies need a global temporary, tiles would race otherwise
+        if constexpr (!is_procedural && !image_view<RhsTraits>::is_procedural)
+        {
+            if (this->is_overlapping_with(rhs))
+            {
+                this->copy_to(rhs, convert);
+                return;
+            }
+        }
+
+        auto const rhs_tileable = detail::as_tileable(rhs);
+        detail::for_each_tile(
+            policy, *this,
+            [&](ipos_t const& start, auto const& tile) {
+                using rhs_extent_t = typename decltype(rhs_tileable)::subview_t::extent_t;
+                tile.copy_to(rhs_tileable.subview(start, rhs_extent_t::from_ivec(tile.extent().to_ivec())), convert);
+            },
+            RhsTraits::layout_type == layout_type::z_order /* rhs subviews must be aligned */, detail::tile_alignment_of<image_view<RhsTraits>>());
+    }
+
     /// same as copy_to but with reversed roles
     template <class RhsTraits, class ConverterT = default_converter>
     void copy_from(image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
     {
         rhs.copy_to(*this, convert);
     }
+    template <class ExecutionPolicy, class RhsTraits, class ConverterT = default_converter>
+    void copy_from(ExecutionPolicy const& policy, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        static_assert(is_execution_policy<ExecutionPolicy>, "first argument must be an execution policy");
+        rhs.copy_to(policy, *this, convert);
+    }
+
+    // selections
+public:
+    /// same as for_each(f) but only visits the pixels of the selection (run by run in row order, see selection.hh)
+    /// the cost is proportional to the number of selected pixels, not to the size of the image
+    /// NOTE: only supported for 2D views, the selection must have the same extent
+    template <class F>
+    void for_each(selection const& sel, F&& f) const
+    {
+        this->check_selection(sel);
+        this->for_each_selected(sel, 0, sel.height(), f);
+    }
+    template <class F>
+    void for_each(sequenced_policy, selection const& sel, F&& f) const
+    {
+        this->for_each(sel, f);
+    }
+    /// NOTE: with tp::par, rows are split into bands with roughly the same number of selected pixels
+    template <class F>
+    void for_each(parallel_policy const& policy, selection const& sel, F&& f) const
+    {
+        this->check_selection(sel);
+        detail::for_each_selection_band(policy, sel, selection_grain_size(policy),
+                                        [&](int y_begin, int y_end) { this->for_each_selected(sel, y_begin, y_end, f); });
+    }
+
+    /// overwrites all selected pixels with the given value
+    void fill(selection const& sel, pixel_t const& value) const
+    {
+        static_assert(is_mutable, "cannot write to this image");
+        this->check_selection(sel);
+        this->fill_selected(sel, 0, sel.height(), value);
+    }
+    void fill(sequenced_policy, selection const& sel, pixel_t const& value) const { this->fill(sel, value); }
+    void fill(parallel_policy const& policy, selection const& sel, pixel_t const& value) const
+    {
+        static_assert(is_mutable, "cannot write to this image");
+        this->check_selection(sel);
+        detail::for_each_selection_band(policy, sel, selection_grain_size(policy),
+                                        [&](int y_begin, int y_end) { this->fill_selected(sel, y_begin, y_end, value); });
+    }
+
+    /// copies all selected pixels to the parameter image (other pixels of rhs are untouched)
+    /// NOTE: same-type runs of trivially copyable pixels are copied via memcpy
+    /// NOTE: unlike copy_to without a selection, source and target must not overlap in memory
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_to(selection const& sel, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        this->check_selection_copy(sel, rhs);
+        this->copy_selected_to(sel, 0, sel.height(), rhs, convert);
+    }
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_to(sequenced_policy, selection const& sel, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        this->copy_to(sel, rhs, convert);
+    }
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_to(parallel_policy const& policy, selection const& sel, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        this->check_selection_copy(sel, rhs);
+        detail::for_each_selection_band(policy, sel, selection_grain_size(policy),
+                                        [&](int y_begin, int y_end) { this->copy_selected_to(sel, y_begin, y_end, rhs, convert); });
+    }
+
+    /// same as copy_to(sel, rhs, convert) but with reversed roles
+    template <class RhsTraits, class ConverterT = default_converter>
+    void copy_from(selection const& sel, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        rhs.copy_to(sel, *this, convert);
+    }
+    template <class ExecutionPolicy, class RhsTraits, class ConverterT = default_converter>
+    void copy_from(ExecutionPolicy const& policy, selection const& sel, image_view<RhsTraits> rhs, ConverterT&& convert = {}) const
+    {
+        static_assert(is_execution_policy<ExecutionPolicy>, "first argument must be an execution policy");
+        rhs.copy_to(policy, sel, *this, convert);
+    }
 
     // creation
 public:
     /// creates an image view from unchecked raw data
+    /// NOTE: fixed-size views assert that byte_stride is their natural stride
+    /// NOTE: for planar views, byte_stride is the stride inside a plane and the planes are assumed to be back to back (see from_planes)
     [[nodiscard]] static image_view from_data(data_ptr_t data, extent_t extent, ivec_t byte_stride)
     {
         image_view v;
         v._data_ptr = data;
         v._extent = extent;
-        v._byte_stride = byte_stride;
+        if constexpr (is_planar)
+            v._byte_stride = storage_view_t::consecutive_planes_stride(byte_stride, extent.to_ivec());
+        else
+            v._byte_stride = byte_stride;
+        return v;
+    }
+
+    /// creates a procedural view from its state (see procedural.hh for the user-facing functions)
+    template <class T = traits>
+    [[nodiscard]] static image_view from_state(extent_t extent, stride_t state)
+    {
+        static_assert(T::layout_type == layout_type::procedural, "only procedural views are created from a state");
+        image_view v;
+        v._extent = extent;
+        v._byte_stride = cc::move(state);
+        return v;
+    }
+
+    /// creates a planar image view from unchecked raw data, where channel c starts at data + c * plane_bytes
+    template <class T = traits>
+    [[nodiscard]] static image_view from_planes(data_ptr_t data, extent_t extent, ivec_t byte_stride, int64_t plane_bytes)
+    {
+        static_assert(T::layout_type == layout_type::planar, "only planar images have planes");
+        image_view v;
+        v._data_ptr = data;
+        v._extent = extent;
+        v._byte_stride = {byte_stride, plane_bytes};
+        return v;
+    }
+
+    /// creates an image view with a runtime channel count from unchecked raw data
+    template <class T = traits>
+    [[nodiscard]] static image_view from_data(data_ptr_t data, extent_t extent, ivec_t byte_stride, int channels)
+    {
+        static_assert(T::has_dynamic_channels, "only images with a runtime channel count have a channels parameter");
+        image_view v;
+        v._data_ptr = data;
+        v._extent = extent;
+        v._byte_stride = {byte_stride, channels};
         return v;
     }
 
+    // helper
+private:
+    using scalar_t = typename traits::pixel_traits::scalar_t;
+
+    /// view with component pixels of type ComponentT starting at the given channel (same strides)
+    template <class ComponentT>
+    auto component_view(int first_channel) const
+    {
+        static_assert(storage_view_t::is_strided_linear, "channel views are only supported for strided linear storage");
+        static_assert(sizeof(pixel_t) == channels * sizeof(scalar_t), "channels must be tightly packed");
+        using component_t = std::conditional_t<std::is_const_v<pixel_t>, ComponentT const, ComponentT>;
+        using view_t = image_view<typename traits::template change_pixel_t<component_t>>;
+        static_assert(!std::is_void_v<typename view_t::traits::base_t>, "image type does not support channel views");
+        return view_t::from_data(_data_ptr + first_channel * int64_t(sizeof(scalar_t)), view_t::extent_t::from_ivec(_extent.to_ivec()), byte_stride());
+    }
+
+    /// the runs along the innermost dimension of a view with a runtime channel count
+    /// (r.data points to the first channel of each pixel, see strided_linear_row_iterator)
+    auto channel_rows(bool merge_rows) const
+    {
+        using row_iterator_t = detail::strided_linear_row_iterator<dimensions, linear_storage_view<pixel_t>>;
+        return detail::srange<row_iterator_t>({_data_ptr, byte_stride(), _extent.to_ivec(), merge_rows});
+    }
+
+    /// computes the bytes spanned by the pixels of this view as [begin, end) (conservative, extent must not be empty)
+    /// NOTE: z-order, tiled and block offsets grow with each coordinate, i.e. the last pixel has the largest offset
+    void memory_range(std::byte const*& begin, std::byte const*& end) const
+    {
+        static_assert(!is_procedural, "procedural views have no memory");
+        auto const e = _extent.to_ivec();
+        if constexpr (storage_view_t::is_strided_linear || has_dynamic_channels)
+        {
+            int64_t lo, hi;
+            detail::strided_offset_range(byte_stride(), e, lo, hi);
+            int64_t pixel_size = sizeof(pixel_t);
+            if constexpr (has_dynamic_channels)
+                pixel_size *= channel_count();
+            begin = _data_ptr + lo;
+            end = _data_ptr + hi + pixel_size;
+        }
+        else if constexpr (is_planar)
+        {
+            int64_t lo, hi;
+            detail::strided_offset_range(_byte_stride.bytes, e, lo, hi);
+            auto const planes = int64_t(_byte_stride.plane_bytes) * (channels - 1);
+            begin = _data_ptr + lo + (planes < 0 ? planes : 0);
+            end = _data_ptr + hi + (planes > 0 ? planes : 0) + int64_t(sizeof(scalar_t));
+        }
+        else
+        {
+            ipos_t last;
+            for (auto d = 0; d < dimensions; ++d)
+                last[d] = e[d] - 1;
+            int64_t element_size = sizeof(pixel_t);
+            if constexpr (traits::is_block_based)
+                element_size = sizeof(typename traits::block_t);
+            begin = _data_ptr;
+            end = _data_ptr + storage_view_t::byte_offset(last, _byte_stride) + element_size;
+        }
+    }
+
+    /// returns true if the memory spanned by this view and rhs intersects (conservative, see memory_range)
+    template <class RhsTraits>
+    bool is_overlapping_with(image_view<RhsTraits> const& rhs) const
+    {
+        if (detail::is_any_zero(_extent.to_ivec()) || detail::is_any_zero(rhs.extent().to_ivec()))
+            return false;
+        std::byte const *begin_a, *end_a, *begin_b, *end_b;
+        this->memory_range(begin_a, end_a);
+        rhs.memory_range(begin_b, end_b);
+        return begin_a < end_b && begin_b < end_a;
+    }
+
+    /// copies via a compact strided linear temporary (for overlapping copies between different layouts)
+    template <class RhsTraits, class ConverterT>
+    void copy_through_temporary(image_view<RhsTraits> const& rhs, ConverterT& convert) const
+    {
+        using tmp_pixel_t = std::remove_const_t<pixel_t>;
+        using tmp_base_traits = std::conditional_t<dimensions == 1, base_traits::linear1D<tmp_pixel_t>,
+                                                   std::conditional_t<dimensions == 2, base_traits::linear2D<tmp_pixel_t>, base_traits::linear3D<tmp_pixel_t>>>;
+        using tmp_view_t = image_view<tmp_base_traits>;
+
+        auto const e = _extent.to_ivec();
+        auto tmp_data = cc::array<std::byte>::uninitialized(size_t(_extent.pixel_count()) * sizeof(tmp_pixel_t));
+        auto tmp = tmp_view_t::from_data(tmp_data.data(), tmp_view_t::extent_t::from_ivec(e), detail::natural_stride_for(int(sizeof(tmp_pixel_t)), e));
+        this->copy_to(tmp);
+        tmp.copy_to(rhs, convert);
+    }
+
+    void check_selection(selection const& sel) const
+    {
+        static_assert(dimensions == 2, "selections are only supported for 2D views");
+        CC_ASSERT(sel.extent().to_ivec() == _extent.to_ivec() && "selection must have the same extent as the image");
+        (void)sel;
+    }
+
+    template <class RhsTraits>
+    void check_selection_copy(selection const& sel, image_view<RhsTraits> const& rhs) const
+    {
+        using rhs_view_t = image_view<RhsTraits>;
+        static_assert(rhs_view_t::is_mutable, "cannot copy into immutable view");
+        static_assert(!has_dynamic_channels && !rhs_view_t::has_dynamic_channels, "selections do not support images with a runtime channel count");
+        this->check_selection(sel);
+        CC_ASSERT(_extent.to_ivec() == rhs.extent().to_ivec() && "extents must match for copy");
+        if constexpr (storage_view_t::is_strided_linear && rhs_view_t::storage_view_t::is_strided_linear)
+            CC_ASSERT(!detail::is_overlapping<dimensions>(_data_ptr, byte_stride(), sizeof(pixel_t), rhs.data_ptr(), rhs.byte_stride(),
+                                                          sizeof(typename rhs_view_t::pixel_t), _extent.to_ivec())
+                      && "selection copies must not overlap");
+    }
+
+    int64_t selection_grain_size(parallel_policy const& policy) const
+    {
+        return policy.grain_size > 0 ? policy.grain_size : detail::default_grain_size<pixel_t>();
+    }
+
+    /// for_each over the selected runs in the rows [y_begin, y_end)
+    template <class F>
+    void for_each_selected(selection const& sel, int y_begin, int y_end, F& f) const
+    {
+        if constexpr (std::is_invocable_v<F, ipos_t>)
+        {
+            sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                for (auto x = x_begin; x < x_end; ++x)
+                    f(ipos_t(x, y));
+            });
+        }
+        else if constexpr (std::is_invocable_v<F, ipos_t, pixel_access_t>)
+        {
+            if constexpr (storage_view_t::is_strided_linear)
+            {
+                auto const s = byte_stride();
+                sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                    auto d = _data_ptr + detail::strided_offset(ipos_t(x_begin, y), s);
+                    for (auto x = x_begin; x < x_end; ++x, d += s.x)
+                        f(ipos_t(x, y), *reinterpret_cast<pixel_t*>(d));
+                });
+            }
+            else
+            {
+                sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                    for (auto x = x_begin; x < x_end; ++x)
+                        f(ipos_t(x, y), this->at_unchecked(ipos_t(x, y)));
+                });
+            }
+        }
+        else
+            static_assert(cc::always_false<F>, "function must be callable with ipos_t or (ipos_t, pixel_access_t)");
+    }
+
+    /// fill of the selected runs in the rows [y_begin, y_end)
+    void fill_selected(selection const& sel, int y_begin, int y_end, pixel_t const& value) const
+    {
+        if constexpr (storage_view_t::is_strided_linear)
+        {
+            auto const s = byte_stride();
+            sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                auto const d = _data_ptr + detail::strided_offset(ipos_t(x_begin, y), s);
+                if (s.x == int(sizeof(pixel_t)))
+                {
+                    auto const p = reinterpret_cast<pixel_t*>(d);
+                    for (auto i = 0; i < x_end - x_begin; ++i)
+                        p[i] = value;
+                }
+                else
+                    for (auto i = 0; i < x_end - x_begin; ++i)
+                        *reinterpret_cast<pixel_t*>(d + int64_t(i) * s.x) = value;
+            });
+        }
+        else if constexpr (has_dynamic_channels)
+        {
+            // every channel is set to value
+            sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                for (auto x = x_begin; x < x_end; ++x)
+                    for (auto& c : this->at_unchecked(ipos_t(x, y)))
+                        c = value;
+            });
+        }
+        else
+        {
+            sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                for (auto x = x_begin; x < x_end; ++x)
+                    this->at_unchecked(ipos_t(x, y)) = value;
+            });
+        }
+    }
+
+    /// copy_to of the selected runs in the rows [y_begin, y_end)
+    template <class RhsTraits, class ConverterT>
+    void copy_selected_to(selection const& sel, int y_begin, int y_end, image_view<RhsTraits> const& rhs, ConverterT& convert) const
+    {
+        using rhs_view_t = image_view<RhsTraits>;
+        using rhs_pixel_t = typename rhs_view_t::pixel_t;
+        constexpr bool is_memcpy_compatible = std::is_same_v<std::remove_const_t<pixel_t>, rhs_pixel_t> && std::is_trivially_copyable_v<rhs_pixel_t>
+                                              && std::is_same_v<std::decay_t<ConverterT>, default_converter>
+                                              && storage_view_t::is_strided_linear && rhs_view_t::storage_view_t::is_strided_linear;
+        if constexpr (is_memcpy_compatible)
+        {
+            auto const s = byte_stride();
+            auto const rs = rhs.byte_stride();
+            if (s.x == int(sizeof(pixel_t)) && rs.x == int(sizeof(pixel_t)))
+            {
+                sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+                    std::memcpy(rhs.data_ptr() + detail::strided_offset(ipos_t(x_begin, y), rs), _data_ptr + detail::strided_offset(ipos_t(x_begin, y), s),
+                                (x_end - x_begin) * sizeof(pixel_t));
+                });
+                return;
+            }
+        }
+
+        sel.for_each_run(y_begin, y_end, [&](int y, int x_begin, int x_end) {
+            for (auto x = x_begin; x < x_end; ++x)
+            {
+                ipos_t const p(x, y);
+                std::remove_const_t<pixel_t> const src = this->at_unchecked(p);
+                if constexpr (std::is_reference_v<typename rhs_view_t::pixel_access_t>)
+                    detail::apply_converter(convert, rhs.at_unchecked(p), src);
+                else
+                {
+                    // proxy pixels (e.g. planar or procedural) are assigned as a whole
+                    rhs_pixel_t dst;
+                    detail::apply_converter(convert, dst, src);
+                    rhs.at_unchecked(p) = dst;
+                }
+            }
+        });
+    }
+
     // unrolled accessors
 public:
     using accessor_t::at;
@@ -273,7 +1359,15 @@ public:
     // members (protected because image derives from this)
 protected:
     data_ptr_t _data_ptr = nullptr;
-    extent_t _extent;
-    ivec_t _byte_stride; // NOTE: in bytes
+    TP_NO_UNIQUE_ADDRESS extent_t _extent;     // empty for fixed extents
+    TP_NO_UNIQUE_ADDRESS stride_t _byte_stride; // NOTE: in bytes, empty for fixed extents
+
+    template <class>
+    friend struct image_view;
 };
+
+// MSVC does not apply the empty base optimization to multiple empty bases, so views are larger there
+#ifndef _MSC_VER
+static_assert(sizeof(image_view<base_traits::fixed2D<float, 4, 4>>) == sizeof(void*), "fixed-size views should only carry the data pointer");
+#endif
 }
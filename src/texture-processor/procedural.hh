@@ -0,0 +1,135 @@
+#pragma once
+
+#include <type_traits>
+
+#include <clean-core/move.hh>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/extents.hh>
+#include <texture-processor/image_view.hh>
+#include <texture-processor/traits.hh>
+
+/**
+ * Procedural and mapped views: lazily computed images without memory
+ *
+ * pixels are computed by a getter functor on each access, so generation is fused into the consumer
+ * (copy_to, samplers, for_each, algorithms) instead of materializing a full-resolution temporary, e.g.
+ *
+ *    auto gradient = tp::procedural_view(tp::extent2{512, 512}, [](tg::ipos2 p) { return float(p.x) / 511; });
+ *    auto sampler = tp::linear_clamped_px_sampler(gradient);
+ *    gradient.copy_to(img); // writes img in its memory order, no temporary
+ *
+ *    auto luminance = tp::mapped_view(rgb_img, [](tg::color3 const& c) { return 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b; });
+ *
+ * views with a setter are writeable, their pixels are proxies that call the setter on assignment
+ * materializing is done via copy_to or image_type_of<ViewT>(view)
+ *
+ * NOTE: functors are stored by value in the view and called concurrently with tp::par
+ * NOTE: functors always receive positions relative to the original view (subviews add their origin)
+ */
+
+namespace tp
+{
+namespace detail
+{
+/// the base traits of strided linear images with the given extent type
+template <class ExtentT, class PixelT>
+struct linear_traits_of;
+template <class PixelT>
+struct linear_traits_of<extent1, PixelT>
+{
+    using type = base_traits::linear1D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<extent2, PixelT>
+{
+    using type = base_traits::linear2D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<extent3, PixelT>
+{
+    using type = base_traits::linear3D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<extent1_array, PixelT>
+{
+    using type = base_traits::linear1D_array<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<extent2_array, PixelT>
+{
+    using type = base_traits::linear2D_array<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<extent_cube, PixelT>
+{
+    using type = base_traits::linear_cube<PixelT>;
+};
+// compile-time and power-of-two extents map to the dynamic extent of the same dimension
+template <int W, class PixelT>
+struct linear_traits_of<fixed_extent1<W>, PixelT>
+{
+    using type = base_traits::linear1D<PixelT>;
+};
+template <int W, int H, class PixelT>
+struct linear_traits_of<fixed_extent2<W, H>, PixelT>
+{
+    using type = base_traits::linear2D<PixelT>;
+};
+template <int W, int H, int D, class PixelT>
+struct linear_traits_of<fixed_extent3<W, H, D>, PixelT>
+{
+    using type = base_traits::linear3D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<pow2_extent1, PixelT>
+{
+    using type = base_traits::linear1D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<pow2_extent2, PixelT>
+{
+    using type = base_traits::linear2D<PixelT>;
+};
+template <class PixelT>
+struct linear_traits_of<pow2_extent3, PixelT>
+{
+    using type = base_traits::linear3D<PixelT>;
+};
+
+template <class ExtentT, class GetterF, class SetterF>
+auto make_procedural_view(ExtentT const& extent, GetterF getter, SetterF setter)
+{
+    using ipos_t = tg::pos<linear_traits_of<ExtentT, float>::type::dimensions, int>;
+    static_assert(std::is_invocable_v<GetterF const&, ipos_t>, "getter must be callable with ipos_t");
+    using pixel_t = std::decay_t<std::invoke_result_t<GetterF const&, ipos_t>>;
+    using linear_t = typename linear_traits_of<ExtentT, pixel_t>::type;
+    using view_t = image_view<base_traits::procedural<pixel_t, linear_t, GetterF, SetterF>>;
+    return view_t::from_state(linear_t::extent_t::from_ivec(extent.to_ivec()), {cc::move(getter), cc::move(setter)});
+}
+}
+
+/// creates a read-only view of the given extent whose pixels are computed by getter(ipos_t) on access
+template <class ExtentT, class GetterF>
+[[nodiscard]] auto procedural_view(ExtentT const& extent, GetterF getter)
+{
+    return detail::make_procedural_view(extent, cc::move(getter), detail::no_setter{});
+}
+
+/// creates a writeable view, pixels are computed by getter(ipos_t) and written via setter(ipos_t, pixel_t const&)
+template <class ExtentT, class GetterF, class SetterF>
+[[nodiscard]] auto procedural_view(ExtentT const& extent, GetterF getter, SetterF setter)
+{
+    return detail::make_procedural_view(extent, cc::move(getter), cc::move(setter));
+}
+
+/// creates a read-only view that applies f to each pixel of view on access
+/// NOTE: the view is captured (non-owning), i.e. its storage must outlive the result
+template <class Traits, class F>
+[[nodiscard]] auto mapped_view(image_view<Traits> view, F f)
+{
+    using ipos_t = typename image_view<Traits>::ipos_t;
+    return procedural_view(view.extent(), [view, f = cc::move(f)](ipos_t const& p) { return f(view.at_unchecked(p)); });
+}
+}
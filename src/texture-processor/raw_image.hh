@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include <clean-core/array.hh>
 #include <clean-core/span.hh>
 
@@ -78,12 +80,25 @@ raw_image::raw_image(image_view<Traits> img)
 
     // init metadata
     _metadata = img.metadata();
-    _metadata.byte_stride = detail::natural_stride_for(_metadata.byte_per_channel * _metadata.channels, _metadata.extent);
-
-    // copy data
-    _data = cc::array<std::byte>::uninitialized(img.byte_size());
-    auto target = image_view<Traits>::from_data(_data.data(), img.extent(), img.byte_stride());
-    img.copy_to(target);
+    using storage_view_t = typename image_view<Traits>::storage_view_t;
+    if constexpr (image_view<Traits>::has_dynamic_channels)
+    {
+        auto const stride = storage_view_t::natural_stride_for(img.extent().to_ivec(), img.channel_count());
+        _metadata.byte_stride = tg::ivec4(stride);
+
+        _data = cc::array<std::byte>::uninitialized(img.byte_size());
+        img.copy_to(image_view<Traits>::from_data(_data.data(), img.extent(), stride, img.channel_count()));
+    }
+    else
+    {
+        auto const stride = typename image_view<Traits>::ivec_t(storage_view_t::natural_stride_for(img.extent().to_ivec()));
+        _metadata.byte_stride = tg::ivec4(stride);
+
+        // copy data (compact target, i.e. a single memcpy if the source has natural stride)
+        _data = cc::array<std::byte>::uninitialized(storage_view_t::storage_size_for(img.extent().to_ivec()) * sizeof(typename Traits::pixel_t));
+        auto target = image_view<Traits>::from_data(_data.data(), img.extent(), stride);
+        img.copy_to(target);
+    }
 }
 
 template <class ImageViewT>
@@ -97,13 +112,15 @@ bool raw_image::can_view_as() const
         return false;
     if (_metadata.layout != ref_md.layout)
         return false;
+    if (_metadata.tile_extent != ref_md.tile_extent)
+        return false;
     if (_metadata.pixel_format != ref_md.pixel_format)
         return false;
     if (_metadata.pixel_space != ref_md.pixel_space)
         return false;
     if (_metadata.byte_per_channel != ref_md.byte_per_channel)
         return false;
-    if (_metadata.channels != ref_md.channels)
+    if (_metadata.channels != ref_md.channels && !(traits::has_dynamic_channels && _metadata.channels > 0))
         return false;
     if (_metadata.max_mipmap != ref_md.max_mipmap)
         return false;
@@ -133,7 +150,10 @@ ImageViewT raw_image::view_as()
     auto extent = ImageViewT::extent_t::from_ivec(ivec_t(_metadata.extent));
     auto byte_stride = ivec_t(_metadata.byte_stride);
 
-    return ImageViewT::from_data(_data.data(), extent, byte_stride);
+    if constexpr (ImageViewT::has_dynamic_channels)
+        return ImageViewT::from_data(_data.data(), extent, byte_stride, int(_metadata.channels));
+    else
+        return ImageViewT::from_data(_data.data(), extent, byte_stride);
 }
 
 template <class ImageViewT>
@@ -153,10 +173,10 @@ ImageT raw_image::convert_to() const
 
     // TODO: support actual conversion
 
-    auto view = view_as<typename ImageT::image_view_t>();
-
-    auto img = ImageT::defaulted(view.extent());
-    view.copy_to(img);
-    return img;
+    // pixels are read via a read-only view and copied into uninitialized storage (and the channel count is adopted)
+    // the view has the layout and extent type of ImageT (e.g. tiles or a fixed extent), so the copy is a plain memcpy where possible
+    using const_traits = typename ImageT::traits::const_traits;
+    static_assert(!std::is_void_v<const_traits>, "image type does not support read-only views");
+    return ImageT(view_as<image_view<const_traits>>());
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <clean-core/assert.hh>
 #include <clean-core/forward.hh>
 
 #include <texture-processor/convert.hh>
@@ -10,6 +11,30 @@
 
 namespace tp
 {
+namespace detail
+{
+/// repeats p into [0, extent) per dimension (negative coordinates continue the pattern)
+template <int D>
+tg::pos<D, int> repeat_pos(tg::pos<D, int> p, tg::vec<D, int> const& extent)
+{
+    for (auto d = 0; d < D; ++d)
+    {
+        auto const v = p[d] % extent[d];
+        p[d] = v < 0 ? v + extent[d] : v;
+    }
+    return p;
+}
+/// same as repeat_pos for power-of-two extents (mask is extent - 1)
+/// two's complement makes negative coordinates wrap correctly
+template <int D>
+tg::pos<D, int> repeat_pos_pow2(tg::pos<D, int> p, tg::vec<D, int> const& mask)
+{
+    for (auto d = 0; d < D; ++d)
+        p[d] &= mask[d];
+    return p;
+}
+}
+
 namespace lookup
 {
 // TODO: allow customized convert
@@ -30,6 +55,41 @@ auto clamped(ViewT view)
         }
     };
 }
+
+/// NOTE: views with power-of-two extents (e.g. pow2_image2) use a bit mask instead of a modulo
+/// NOTE: the view must not be empty (there is nothing to repeat)
+template <class PixelT, class ViewT>
+auto repeated(ViewT view)
+{
+    CC_ASSERT(!view.empty() && "cannot repeat an empty view");
+    using ipos_t = typename ViewT::ipos_t;
+    constexpr bool use_mask = ViewT::traits::has_pow2_extent;
+    return [view, e = view.extent().to_ivec() - (use_mask ? 1 : 0)](ipos_t const& p) -> decltype(auto) {
+        // repeated lookup
+        ipos_t rp;
+        if constexpr (use_mask)
+            rp = detail::repeat_pos_pow2(p, e);
+        else
+            rp = detail::repeat_pos(p, e);
+
+        if constexpr (std::is_same_v<PixelT, typename ViewT::pixel_t>)
+            return view(rp);
+        else
+        {
+            auto src = view(rp);
+            PixelT target;
+            default_converter{}(target, src);
+            return target;
+        }
+    };
+}
+
+/// for integer pixel lookups, wrapping around is the same as repeating
+template <class PixelT, class ViewT>
+auto wrapped(ViewT view)
+{
+    return repeated<PixelT>(view);
+}
 }
 
 namespace interpolation
@@ -150,4 +210,18 @@ auto linear_clamped_px_sampler(ViewT view)
     using pixel_t = tg::same_or<PixelT, typename ViewT::pixel_t>;
     return sampler(view, interpolation::linear<pixel_t, ViewT>(lookup::clamped<pixel_t>(view)));
 }
+
+template <class PixelT = void, class ViewT>
+auto linear_repeated_px_sampler(ViewT view)
+{
+    using pixel_t = tg::same_or<PixelT, typename ViewT::pixel_t>;
+    return sampler(view, interpolation::linear<pixel_t, ViewT>(lookup::repeated<pixel_t>(view)));
+}
+
+template <class PixelT = void, class ViewT>
+auto linear_wrapped_px_sampler(ViewT view)
+{
+    using pixel_t = tg::same_or<PixelT, typename ViewT::pixel_t>;
+    return sampler(view, interpolation::linear<pixel_t, ViewT>(lookup::wrapped<pixel_t>(view)));
+}
 }
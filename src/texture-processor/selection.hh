@@ -0,0 +1,346 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include <clean-core/assert.hh>
+#include <clean-core/move.hh>
+#include <clean-core/span.hh>
+#include <clean-core/vector.hh>
+
+#include <typed-geometry/tg-lean.hh>
+
+#include <texture-processor/execution.hh>
+#include <texture-processor/extents.hh>
+#include <texture-processor/traits.hh>
+
+/**
+ * Selections: sparse 2D pixel masks stored as runs per row
+ *
+ * algorithms that take a selection (for_each, fill, copy_to, copy_from) only visit the selected runs,
+ * so their cost scales with the size of the selection instead of the size of the image, e.g.
+ *
+ *    auto sel = tp::selection::from_mask(brush_mask); // any 2D image with pixels convertible to bool
+ *    sel = sel | tp::selection::from_disk(canvas.extent(), {200, 300}, 25.f);
+ *    canvas.fill(sel, tg::color3::red);
+ *    canvas.for_each(tp::par, sel, [](tg::ipos2 p, tg::color3& c) { c *= 0.5f; });
+ *    (layer * opacity + canvas).copy_to(sel, canvas); // lazy expressions only evaluate selected pixels
+ *
+ * the runs of each row are sorted and maximal (i.e. neither overlapping nor adjacent)
+ * NOTE: the extent of a selection must match the extent of the images it is used with
+ */
+
+namespace tp
+{
+/// half-open range [x_begin, x_end) of selected pixels inside a row
+struct selection_run
+{
+    int x_begin = 0;
+    int x_end = 0;
+
+    int size() const { return x_end - x_begin; }
+};
+
+struct selection
+{
+    // properties
+public:
+    extent2 const& extent() const { return _extent; }
+    int width() const { return _extent.width; }
+    int height() const { return _extent.height; }
+
+    /// number of selected pixels
+    int64_t pixel_count() const { return _pixel_count; }
+
+    /// number of runs over all rows
+    int64_t run_count() const { return int64_t(_runs.size()); }
+
+    /// returns true if no pixel is selected
+    bool empty() const { return _pixel_count == 0; }
+
+    /// the runs of row y (sorted by x)
+    cc::span<selection_run const> row(int y) const
+    {
+        CC_ASSERT(0 <= y && y < _extent.height && "row out of bounds");
+        auto const begin = _row_offsets[y];
+        return {_runs.data() + begin, size_t(_row_offsets[y + 1] - begin)};
+    }
+
+    /// returns true iff the pixel p is selected (binary search in its row)
+    bool contains(tg::ipos2 const& p) const
+    {
+        if (p.x < 0 || p.y < 0 || p.x >= _extent.width || p.y >= _extent.height)
+            return false;
+
+        auto lo = _row_offsets[p.y];
+        auto hi = _row_offsets[p.y + 1];
+        while (lo < hi)
+        {
+            auto const mid = lo + (hi - lo) / 2;
+            if (_runs[mid].x_end <= p.x)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < _row_offsets[p.y + 1] && _runs[lo].x_begin <= p.x;
+    }
+
+    /// calls f(y, x_begin, x_end) for each run in the rows [y_begin, y_end)
+    template <class F>
+    void for_each_run(int y_begin, int y_end, F&& f) const
+    {
+        for (auto y = y_begin; y < y_end; ++y)
+            for (auto i = _row_offsets[y]; i < _row_offsets[y + 1]; ++i)
+                f(y, _runs[i].x_begin, _runs[i].x_end);
+    }
+    template <class F>
+    void for_each_run(F&& f) const
+    {
+        this->for_each_run(0, _extent.height, f);
+    }
+
+    // creation
+public:
+    selection() = default;
+
+    /// a selection of the given extent without any selected pixels
+    [[nodiscard]] static selection none(extent2 e)
+    {
+        builder b(e);
+        for (auto y = 0; y < e.height; ++y)
+            b.end_row();
+        return b.finish();
+    }
+
+    /// a selection of the given extent where all pixels are selected
+    [[nodiscard]] static selection all(extent2 e)
+    {
+        builder b(e);
+        for (auto y = 0; y < e.height; ++y)
+        {
+            b.add(0, e.width);
+            b.end_row();
+        }
+        return b.finish();
+    }
+
+    /// selects all pixels inside the (inclusive) box, clipped to the extent
+    [[nodiscard]] static selection from_rect(extent2 e, tg::aabb<2, int> const& bb)
+    {
+        builder b(e);
+        for (auto y = 0; y < e.height; ++y)
+        {
+            if (bb.min.y <= y && y <= bb.max.y)
+                b.add(bb.min.x, bb.max.x + 1);
+            b.end_row();
+        }
+        return b.finish();
+    }
+
+    /// selects all pixels whose position lies within radius of center, clipped to the extent
+    [[nodiscard]] static selection from_disk(extent2 e, tg::pos2 const& center, float radius)
+    {
+        builder b(e);
+        for (auto y = 0; y < e.height; ++y)
+        {
+            auto const dy = float(y) - center.y;
+            auto const h2 = radius * radius - dy * dy;
+            if (h2 >= 0)
+            {
+                auto const h = std::sqrt(h2);
+                b.add(int(std::ceil(center.x - h)), int(std::floor(center.x + h)) + 1);
+            }
+            b.end_row();
+        }
+        return b.finish();
+    }
+
+    /// selects all pixels p of the 2D image or view where is_selected(mask(p)) is true
+    /// (per default, pixels are tested via their conversion to bool, e.g. for bool or u8 masks)
+    template <class ImageOrViewT>
+    [[nodiscard]] static selection from_mask(ImageOrViewT const& mask)
+    {
+        return from_mask(mask, [](auto const& v) { return bool(v); });
+    }
+    template <class ImageOrViewT, class PredicateF>
+    [[nodiscard]] static selection from_mask(ImageOrViewT const& mask, PredicateF&& is_selected)
+    {
+        static_assert(is_image_or_view<ImageOrViewT>);
+        static_assert(ImageOrViewT::dimensions == 2, "selections are only supported for 2D images");
+
+        auto const e = extent2::from_ivec(mask.extent().to_ivec());
+        builder b(e);
+        for (auto y = 0; y < e.height; ++y)
+        {
+            auto x = 0;
+            while (x < e.width)
+            {
+                while (x < e.width && !is_selected(mask.at_unchecked({x, y})))
+                    ++x;
+                auto const x_begin = x;
+                while (x < e.width && is_selected(mask.at_unchecked({x, y})))
+                    ++x;
+                b.add(x_begin, x);
+            }
+            b.end_row();
+        }
+        return b.finish();
+    }
+
+    // set operations
+public:
+    /// all pixels that are not selected
+    [[nodiscard]] selection inverted() const
+    {
+        builder b(_extent);
+        for (auto y = 0; y < _extent.height; ++y)
+        {
+            auto x = 0;
+            for (auto const& r : row(y))
+            {
+                b.add(x, r.x_begin);
+                x = r.x_end;
+            }
+            b.add(x, _extent.width);
+            b.end_row();
+        }
+        return b.finish();
+    }
+
+    /// pixels selected in any of both selections
+    [[nodiscard]] friend selection operator|(selection const& a, selection const& b)
+    {
+        CC_ASSERT(a._extent == b._extent && "selections must have the same extent");
+        builder res(a._extent);
+        for (auto y = 0; y < a._extent.height; ++y)
+        {
+            // runs are added in order of x_begin, the builder merges overlapping ones
+            auto ra = a.row(y);
+            auto rb = b.row(y);
+            size_t i = 0, j = 0;
+            while (i < ra.size() || j < rb.size())
+            {
+                auto const& r = j == rb.size() || (i < ra.size() && ra[i].x_begin < rb[j].x_begin) ? ra[i++] : rb[j++];
+                res.add(r.x_begin, r.x_end);
+            }
+            res.end_row();
+        }
+        return res.finish();
+    }
+
+    /// pixels selected in both selections
+    [[nodiscard]] friend selection operator&(selection const& a, selection const& b)
+    {
+        CC_ASSERT(a._extent == b._extent && "selections must have the same extent");
+        builder res(a._extent);
+        for (auto y = 0; y < a._extent.height; ++y)
+        {
+            auto ra = a.row(y);
+            auto rb = b.row(y);
+            size_t i = 0, j = 0;
+            while (i < ra.size() && j < rb.size())
+            {
+                auto const x_begin = ra[i].x_begin < rb[j].x_begin ? rb[j].x_begin : ra[i].x_begin;
+                auto const x_end = ra[i].x_end < rb[j].x_end ? ra[i].x_end : rb[j].x_end;
+                res.add(x_begin, x_end);
+                if (ra[i].x_end < rb[j].x_end)
+                    ++i;
+                else
+                    ++j;
+            }
+            res.end_row();
+        }
+        return res.finish();
+    }
+
+    /// pixels selected in a but not in b
+    [[nodiscard]] friend selection operator-(selection const& a, selection const& b) { return a & b.inverted(); }
+
+    selection& operator|=(selection const& rhs) { return *this = *this | rhs; }
+    selection& operator&=(selection const& rhs) { return *this = *this & rhs; }
+    selection& operator-=(selection const& rhs) { return *this = *this - rhs; }
+
+    // helper
+private:
+    /// builds a selection row by row
+    /// runs must be added with non-decreasing x_begin, they are clipped to the extent and merged with the previous run if they touch
+    struct builder
+    {
+        explicit builder(extent2 e)
+        {
+            _sel._extent = e;
+            _sel._row_offsets.push_back(0);
+        }
+
+        void add(int x_begin, int x_end)
+        {
+            x_begin = x_begin < 0 ? 0 : x_begin;
+            x_end = x_end > _sel._extent.width ? _sel._extent.width : x_end;
+            if (x_begin >= x_end)
+                return;
+
+            auto& runs = _sel._runs;
+            if (int(runs.size()) > _sel._row_offsets.back() && x_begin <= runs.back().x_end)
+            {
+                CC_ASSERT(runs.back().x_begin <= x_begin && "runs must be added in order");
+                if (x_end > runs.back().x_end)
+                {
+                    _sel._pixel_count += x_end - runs.back().x_end;
+                    runs.back().x_end = x_end;
+                }
+                return;
+            }
+
+            runs.push_back({x_begin, x_end});
+            _sel._pixel_count += x_end - x_begin;
+        }
+
+        void end_row() { _sel._row_offsets.push_back(int(_sel._runs.size())); }
+
+        selection finish()
+        {
+            CC_ASSERT(int(_sel._row_offsets.size()) == _sel._extent.height + 1 && "not all rows were built");
+            return cc::move(_sel);
+        }
+
+    private:
+        selection _sel;
+    };
+
+    // members
+private:
+    extent2 _extent;
+    cc::vector<selection_run> _runs;
+    cc::vector<int> _row_offsets; // runs of row y are [_row_offsets[y], _row_offsets[y + 1])
+    int64_t _pixel_count = 0;
+};
+
+namespace detail
+{
+/// calls f(y_begin, y_end) for bands of rows with roughly grain_size selected pixels each, distributed over the policy's thread pool
+/// (bands are balanced by selected pixels, so sparse selections do not produce mostly empty tasks)
+template <class F>
+void for_each_selection_band(parallel_policy const& policy, selection const& sel, int64_t grain_size, F&& f)
+{
+    if (sel.empty())
+        return;
+
+    cc::vector<int> band_starts;
+    band_starts.push_back(0);
+    int64_t pixels = 0;
+    for (auto y = 0; y < sel.height(); ++y)
+    {
+        for (auto const& r : sel.row(y))
+            pixels += r.size();
+        if (pixels >= grain_size && y + 1 < sel.height())
+        {
+            band_starts.push_back(y + 1);
+            pixels = 0;
+        }
+    }
+    band_starts.push_back(sel.height());
+
+    policy.get_pool().parallel_for(int64_t(band_starts.size()) - 1, [&](int64_t i) { f(band_starts[i], band_starts[i + 1]); });
+}
+}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include <clean-core/assert.hh>
+#include <clean-core/move.hh>
+
+#include <texture-processor/image.hh>
+#include <texture-processor/image_view.hh>
+
+namespace tp
+{
+/**
+ * A reference-counted image with copy-on-write semantics
+ *
+ * copies are O(1) and share the pixels until a mutable view is requested,
+ * at which point a shared image is deep-copied first (only the writer pays for the copy)
+ * this is useful when images pass through many processing stages unchanged (e.g. asset pipelines)
+ *
+ * usage:
+ *    tp::shared_image2<tg::color3> a = cc::move(img); // no copy
+ *    auto b = a;                                     // O(1), pixels are shared
+ *    b.mutable_view().fill(tg::color3::red);         // b detaches, a is unchanged
+ *
+ * NOTE: reading is only possible via read-only views, as image views cannot detect writes
+ * NOTE: views obtained before mutable_view() still point to the old (shared) pixels
+ * NOTE: the reference count is atomic, so copies may be passed between threads
+ *       a single shared_image object must not be copied and written concurrently
+ * NOTE: the sole-owner check uses an acquire load of the count, which synchronizes with the release of other holders,
+ *       so all reads through a released copy happen before the pixels are written in place
+ */
+template <class BaseTraits>
+struct shared_image
+{
+    using image_t = image<BaseTraits>;
+    using traits = typename image_t::traits;
+    using pixel_t = typename traits::pixel_t;
+    using extent_t = typename traits::extent_t;
+    using view_t = image_view<BaseTraits>;
+    using const_view_t = decltype(std::declval<view_t const&>().readonly());
+
+    // ctors
+public:
+    shared_image() = default;
+    ~shared_image() { release_ref(); }
+
+    /// takes ownership of the image (move it in to avoid copying the pixels)
+    shared_image(image_t img) : _node(new node{cc::move(img)}) {}
+
+    /// copies the view into a new (unshared) image
+    explicit shared_image(view_t view) : _node(new node{image_t(view)}) {}
+
+    /// O(1), the pixels are shared
+    shared_image(shared_image const& rhs) : _node(rhs._node)
+    {
+        if (_node)
+            _node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    shared_image(shared_image&& rhs) noexcept : _node(rhs._node) { rhs._node = nullptr; }
+    shared_image& operator=(shared_image const& rhs)
+    {
+        shared_image tmp = rhs;
+        std::swap(_node, tmp._node);
+        return *this;
+    }
+    shared_image& operator=(shared_image&& rhs) noexcept
+    {
+        std::swap(_node, rhs._node);
+        return *this;
+    }
+
+    // properties
+public:
+    /// returns true if this does not hold an image
+    bool is_null() const { return _node == nullptr; }
+
+    /// returns true if the pixels are shared with other shared_images (i.e. a write would copy them)
+    bool is_shared() const { return use_count() > 1; }
+
+    /// number of shared_images sharing these pixels (0 if null)
+    long use_count() const { return _node ? _node->refs.load(std::memory_order_acquire) : 0; }
+
+    extent_t extent() const
+    {
+        CC_ASSERT(_node && "null shared image");
+        return _node->image.extent();
+    }
+
+    // access
+public:
+    /// returns a read-only view onto the (possibly shared) pixels
+    const_view_t view() const
+    {
+        CC_ASSERT(_node && "null shared image");
+        return _node->image.readonly();
+    }
+
+    /// returns a mutable view onto the pixels, deep-copying them first if they are shared
+    view_t mutable_view()
+    {
+        detach();
+        return _node->image.view();
+    }
+
+    /// returns an independent image with the same pixels (moved out if not shared, copied otherwise)
+    /// NOTE: this shared_image is null afterwards
+    image_t release()
+    {
+        detach();
+        auto img = cc::move(_node->image);
+        release_ref();
+        return img;
+    }
+
+    /// makes sure the pixels are not shared (deep-copies them if necessary)
+    void detach()
+    {
+        CC_ASSERT(_node && "null shared image");
+        if (is_shared())
+        {
+            auto const copy = new node{image_t(_node->image)};
+            release_ref();
+            _node = copy;
+        }
+    }
+
+    // helper
+private:
+    struct node
+    {
+        image_t image;
+        std::atomic<long> refs = 1;
+    };
+
+    /// drops this reference (deleting the image if it was the last one), null afterwards
+    void release_ref()
+    {
+        if (_node && _node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete _node;
+        _node = nullptr;
+    }
+
+    // members
+private:
+    node* _node = nullptr;
+};
+}
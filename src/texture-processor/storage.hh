@@ -1,80 +1,312 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
 
-#include <clean-core/array.hh>
+#include <clean-core/always_false.hh>
+#include <clean-core/assert.hh>
+#include <clean-core/move.hh>
+
+#include <texture-processor/allocator.hh>
+#include <texture-processor/pixel_traits.hh>
 
 // storage classes manage the backing data of an image
 // access into that data is managed by a storage_view
 namespace tp
 {
+namespace detail
+{
+/// element buffer of the storages with vector-like capacity
+/// the allocation is reused whenever the new size fits (e.g. when resizing every frame)
+/// memory comes from a tp::allocator (the heap by default, see allocator.hh)
+/// NOTE: all capacity() elements are constructed, only the first size() elements belong to the image
+/// NOTE: resize_* does not preserve content, reserve and shrink_to_fit do
+/// NOTE: copies are allocated from the heap (like std::pmr containers), moves take the allocator along
+/// NOTE: allocations are at least cache-line aligned (see set_alignment), copies keep the alignment
 template <class T>
-struct linear_storage
+struct storage_buffer
 {
-    cc::array<T> data;
+    storage_buffer() = default;
+    ~storage_buffer() { release(); }
+
+    storage_buffer(storage_buffer&& rhs) noexcept
+      : _data(rhs._data), _size(rhs._size), _capacity(rhs._capacity), _alignment(rhs._alignment), _allocator(rhs._allocator)
+    {
+        rhs._data = nullptr;
+        rhs._size = 0;
+        rhs._capacity = 0;
+    }
+    storage_buffer& operator=(storage_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            release();
+            _data = rhs._data;
+            _size = rhs._size;
+            _capacity = rhs._capacity;
+            _alignment = rhs._alignment;
+            _allocator = rhs._allocator;
+            rhs._data = nullptr;
+            rhs._size = 0;
+            rhs._capacity = 0;
+        }
+        return *this;
+    }
+
+    // copies only contain the used elements, which are copy-constructed in place
+    storage_buffer(storage_buffer const& rhs) : _alignment(rhs._alignment)
+    {
+        allocate(rhs._size);
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (rhs._size > 0)
+                std::memcpy(_data, rhs._data, rhs._size * sizeof(T));
+        }
+        else
+            for (uint64_t i = 0; i < rhs._size; ++i)
+                new (_data + i) T(rhs._data[i]);
+        _size = rhs._size;
+    }
+    storage_buffer& operator=(storage_buffer const& rhs)
+    {
+        if (this != &rhs)
+        {
+            if (rhs._size > _capacity)
+            {
+                release();
+                allocate(rhs._size);
+                _capacity = 0; // elements are constructed below
+                construct_n(rhs._size, [&](T* p, uint64_t i) { new (p) T(rhs._data[i]); });
+            }
+            else if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if (rhs._size > 0)
+                    std::memcpy(_data, rhs._data, rhs._size * sizeof(T));
+            }
+            else
+                for (uint64_t i = 0; i < rhs._size; ++i)
+                    _data[i] = rhs._data[i];
+            _size = rhs._size;
+        }
+        return *this;
+    }
+
+    T* data() const { return _data; }
+    uint64_t size() const { return _size; }
+    uint64_t capacity() const { return _capacity; }
+
+    tp::allocator& get_allocator() const { return *_allocator; }
+    /// sets the allocator used for all future allocations (the storage must not hold memory)
+    void set_allocator(tp::allocator& a)
+    {
+        CC_ASSERT(_data == nullptr && "cannot change the allocator of a storage that holds memory");
+        _allocator = &a;
+    }
+
+    size_t alignment() const { return _alignment; }
+    /// sets the minimum alignment of the allocation in bytes (a power of two, e.g. 4096 for page-aligned storage)
+    /// an existing allocation is moved into a new one (keeping the used elements) if the alignment changes
+    void set_alignment(size_t a)
+    {
+        CC_ASSERT(a != 0 && (a & (a - 1)) == 0 && "alignment must be a power of two");
+        a = a < alignof(T) ? alignof(T) : a;
+        if (a == _alignment)
+            return;
+        if (_data == nullptr)
+            _alignment = a;
+        else
+            reallocate_keeping(_capacity, a);
+    }
 
     void resize_uninitialized(uint64_t size)
     {
-        if (data.size() != size)
-            data = cc::array<T>::uninitialized(size);
+        if (size > _capacity)
+            reallocate_discarding(size, [](T* p, uint64_t) { new (p) T; });
+        _size = size;
+    }
+    /// same as resize_uninitialized, but new allocations of implicit-lifetime types (trivially copyable and destructible)
+    /// are not constructed at all, so their memory is not touched before the caller writes it
+    /// (the OS places pages on the NUMA node of the thread that touches them first)
+    void resize_for_overwrite(uint64_t size)
+    {
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>)
+        {
+            if (size > _capacity)
+            {
+                auto const capacity = grown_capacity(size);
+                release();
+                allocate(capacity);
+            }
+            _size = size;
+        }
+        else
+            resize_uninitialized(size);
     }
     void resize_defaulted(uint64_t size)
     {
-        if (data.size() != size)
-            data = cc::array<T>::defaulted(size);
+        if (size > _capacity)
+            reallocate_discarding(size, [](T* p, uint64_t) { new (p) T(); });
         else
-            for (auto& v : data)
-                v = {};
+            for (uint64_t i = 0; i < size; ++i)
+                _data[i] = {};
+        _size = size;
     }
     void resize_filled(uint64_t size, T const& value)
     {
-        if (data.size() != size)
-            data = cc::array<T>::filled(size, value);
+        if (size > _capacity)
+            reallocate_discarding(size, [&](T* p, uint64_t) { new (p) T(value); });
         else
-            for (auto& v : data)
-                v = value;
+            for (uint64_t i = 0; i < size; ++i)
+                _data[i] = value;
+        _size = size;
     }
-};
 
-template <class T, class BlockT>
-struct linear_block_storage
-{
-    cc::array<BlockT> data;
+    /// makes sure that capacity elements fit without reallocation (the used elements are kept)
+    void reserve(uint64_t capacity)
+    {
+        if (capacity > _capacity)
+            reallocate_keeping(capacity, _alignment);
+    }
 
-    void resize_uninitialized(uint64_t size)
+    /// releases the unused capacity (the used elements are kept)
+    void shrink_to_fit()
     {
-        if (data.size() != size)
-            data = cc::array<T>::uninitialized(size);
+        if (_size != _capacity)
+            reallocate_keeping(_size, _alignment);
     }
-    void resize_defaulted(uint64_t size)
+
+private:
+    // cache lines are 64 bytes on all relevant platforms
+    static constexpr size_t default_alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+    /// the first allocation is exact, growing an existing one is geometric (so repeated growing is amortized)
+    uint64_t grown_capacity(uint64_t size) const
     {
-        if (data.size() != size)
-            data = cc::array<T>::defaulted(size);
+        auto const grown = _capacity + _capacity / 2;
+        return _capacity == 0 || size > grown ? size : grown;
+    }
+
+    /// allocates raw memory for n elements (_capacity is set, but nothing is constructed yet)
+    void allocate(uint64_t n)
+    {
+        _data = n == 0 ? nullptr : reinterpret_cast<T*>(_allocator->allocate(n * sizeof(T), _alignment));
+        _capacity = n;
+    }
+
+    /// constructs elements [_capacity, n) via init(ptr, index), _capacity is n afterwards
+    template <class InitF>
+    void construct_n(uint64_t n, InitF&& init)
+    {
+        for (auto i = _capacity; i < n; ++i)
+            init(_data + i, i);
+        _capacity = n;
+    }
+
+    /// destroys all elements and returns the memory to the allocator
+    void release()
+    {
+        if (_data == nullptr)
+            return;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            for (uint64_t i = 0; i < _capacity; ++i)
+                _data[i].~T();
+        _allocator->deallocate(reinterpret_cast<std::byte*>(_data), _capacity * sizeof(T), _alignment);
+        _data = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+    template <class InitF>
+    void reallocate_discarding(uint64_t size, InitF&& init)
+    {
+        auto const capacity = grown_capacity(size);
+        release();
+        allocate(capacity);
+        _capacity = 0;
+        construct_n(capacity, init);
+    }
+
+    void reallocate_keeping(uint64_t capacity, size_t alignment)
+    {
+        storage_buffer res;
+        res._allocator = _allocator;
+        res._alignment = alignment;
+        res.allocate(capacity);
+        res._capacity = 0;
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (_size > 0)
+                std::memcpy(res._data, _data, _size * sizeof(T));
+            res.construct_n(capacity, [&](T* p, uint64_t i) {
+                if (i >= _size)
+                    new (p) T;
+            });
+        }
         else
-            for (auto& v : data)
-                v = {};
+            res.construct_n(capacity, [&](T* p, uint64_t i) {
+                if (i < _size)
+                    new (p) T(cc::move(_data[i]));
+                else
+                    new (p) T;
+            });
+        res._size = _size;
+        *this = cc::move(res);
     }
-    void resize_filled(uint64_t, T const&) { static_assert(cc::always_false<T, BlockT>, "TODO: implement me"); }
+
+    T* _data = nullptr;
+    uint64_t _size = 0;
+    uint64_t _capacity = 0;
+    size_t _alignment = default_alignment;
+    tp::allocator* _allocator = &tp::allocator::heap();
 };
+}
 
 template <class T>
-struct z_storage
+struct linear_storage : detail::storage_buffer<T>
 {
-    cc::array<T> data;
+};
 
-    void resize_uninitialized(uint64_t size)
-    {
-        if (data.size() != size)
-            data = cc::array<T>::uninitialized(size);
-    }
-    void resize_defaulted(uint64_t size)
+template <class T, class BlockT>
+struct linear_block_storage : detail::storage_buffer<BlockT> // NOTE: size is in blocks
+{
+    void resize_filled(uint64_t, T const&) { static_assert(cc::always_false<T, BlockT>, "filling block images requires encoding, not supported"); }
+};
+
+template <class T>
+struct z_storage : detail::storage_buffer<T>
+{
+};
+
+/// one contiguous plane per channel, planes are stored back to back
+/// NOTE: size and capacity are in pixels (the data contains channels * size() scalars)
+template <class T>
+struct planar_storage : detail::storage_buffer<typename pixel_traits<std::remove_const_t<T>>::scalar_t>
+{
+    using scalar_t = typename pixel_traits<std::remove_const_t<T>>::scalar_t;
+    using buffer_t = detail::storage_buffer<scalar_t>;
+    static constexpr int channels = pixel_traits<std::remove_const_t<T>>::channels;
+
+    uint64_t size() const { return buffer_t::size() / channels; }
+    uint64_t capacity() const { return buffer_t::capacity() / channels; }
+
+    void resize_uninitialized(uint64_t size) { buffer_t::resize_uninitialized(size * channels); }
+    void resize_for_overwrite(uint64_t size) { buffer_t::resize_for_overwrite(size * channels); }
+    void resize_defaulted(uint64_t size) { buffer_t::resize_defaulted(size * channels); }
+    void resize_filled(uint64_t size, T const& value)
     {
-        if (data.size() != size)
-            data = cc::array<T>::defaulted(size);
-        else
-            for (auto& v : data)
-                v = {};
+        resize_uninitialized(size);
+        for (auto c = 0; c < channels; ++c)
+            for (uint64_t i = 0; i < size; ++i)
+                this->data()[c * size + i] = value[c];
     }
-    void resize_filled(uint64_t size, T const& value) { data = cc::array<T>::filled(size, value); }
+    void reserve(uint64_t capacity) { buffer_t::reserve(capacity * channels); }
+};
+
+/// NOTE: size includes the padding of partial tiles at the border
+template <class T>
+struct tiled_storage : detail::storage_buffer<T>
+{
 };
 }
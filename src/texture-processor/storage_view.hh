@@ -1,12 +1,26 @@
 #pragma once
 
+#include <cstdint>
+
+#include <clean-core/assert.hh>
+#include <clean-core/span.hh>
+
 #include <typed-geometry/tg-lean.hh>
 
+#include <texture-processor/convert.hh>
+#include <texture-processor/detail/functor.hh>
+#include <texture-processor/detail/morton.hh>
 #include <texture-processor/detail/predicates.hh>
+#include <texture-processor/pixel_traits.hh>
 
 // storage views are trait-like classes (static)
 // they provide access into storage given by a data ptr
 // NOTE: pixel_at is called from image_view and is already range-checked
+//
+// in addition to pixel_at, each storage view provides:
+//   byte_offset(pos, stride)        - offset of a pixel relative to the data ptr (used for subviews)
+//   natural_stride_for(extent)      - the stride of a compactly stored image
+//   storage_size_for(extent)        - the number of elements that a compact storage needs
 namespace tp
 {
 template <class T>
@@ -14,6 +28,7 @@ struct linear_storage_view
 {
     static constexpr bool is_strided_linear = true;
 
+    using pixel_t = T;
     using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
     using pixel_access_t = T&;
 
@@ -22,15 +37,499 @@ struct linear_storage_view
     {
         return *reinterpret_cast<T*>(data + detail::strided_offset(p, stride));
     }
+
+    template <int D>
+    static int64_t byte_offset(tg::pos<D, int> p, tg::vec<D, int> stride)
+    {
+        return detail::strided_offset(p, stride);
+    }
+
+    template <int D>
+    static tg::vec<D, int> natural_stride_for(tg::vec<D, int> extent)
+    {
+        return detail::natural_stride_for(sizeof(T), extent);
+    }
+
+    template <int D>
+    static uint64_t storage_size_for(tg::vec<D, int> extent)
+    {
+        uint64_t s = 1;
+        for (auto i = 0; i < D; ++i)
+            s *= uint64_t(extent[i]);
+        return s;
+    }
+};
+/// compact linear storage of a fixed-size image (see fixed_extentN)
+/// the stride is derived from the extent at compile time, i.e. the stride argument is ignored
+/// and all offsets are constant-folded
+template <class T, class ExtentT>
+struct fixed_linear_storage_view
+{
+    static constexpr bool is_strided_linear = true;
+    static constexpr int dimensions = ExtentT::dimensions;
+
+    using pixel_t = T;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = T&;
+    using ivec_t = tg::vec<dimensions, int>;
+    using ipos_t = tg::pos<dimensions, int>;
+
+    static constexpr ivec_t stride = detail::natural_stride_for(int(sizeof(T)), ExtentT::to_ivec());
+
+    template <class StrideT>
+    static pixel_access_t pixel_at(data_ptr_t data, ipos_t p, StrideT const&)
+    {
+        return *reinterpret_cast<T*>(data + detail::strided_offset(p, stride));
+    }
+
+    template <class StrideT>
+    static int64_t byte_offset(ipos_t p, StrideT const&)
+    {
+        return detail::strided_offset(p, stride);
+    }
+
+    static ivec_t natural_stride_for(ivec_t const&) { return stride; }
+    static uint64_t storage_size_for(ivec_t const&) { return ExtentT::pixel_count(); }
+};
+
+/// the stride type of fixed-size views, holds no state
+/// converts to the (compile-time) natural stride and only accepts it on construction
+template <class StorageViewT>
+struct fixed_stride
+{
+    using ivec_t = typename StorageViewT::ivec_t;
+    static constexpr ivec_t value = StorageViewT::stride;
+
+    fixed_stride() = default;
+    fixed_stride(ivec_t const& s)
+    {
+        CC_ASSERT(s == value && "fixed-size views only support their natural stride");
+        (void)s;
+    }
+
+    constexpr operator ivec_t() const { return value; }
+    int operator[](int i) const { return value[i]; }
+};
+
+template <class StorageViewT>
+struct pow2_stride;
+
+/// linear storage of a power-of-two image (see pow2_extentN)
+/// strides are power-of-two multiples of the pixel size, so addressing only needs shifts instead of multiplies
+template <class T, int D>
+struct pow2_linear_storage_view
+{
+    static constexpr bool is_strided_linear = true;
+    static constexpr int dimensions = D;
+
+    using pixel_t = T;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = T&;
+    using ivec_t = tg::vec<D, int>;
+    using ipos_t = tg::pos<D, int>;
+    using stride_t = pow2_stride<pow2_linear_storage_view>;
+
+    static int64_t pixel_index(ipos_t const& p, stride_t const& stride)
+    {
+        int64_t i = 0;
+        for (auto d = 0; d < D; ++d)
+            i += int64_t(p[d]) << stride.shifts[d];
+        return i;
+    }
+
+    static pixel_access_t pixel_at(data_ptr_t data, ipos_t const& p, stride_t const& stride)
+    {
+        return reinterpret_cast<T*>(data)[pixel_index(p, stride)];
+    }
+
+    static int64_t byte_offset(ipos_t const& p, stride_t const& stride) { return pixel_index(p, stride) * int64_t(sizeof(T)); }
+
+    /// NOTE: empty dimensions are treated as 1 (so that the stride stays representable)
+    static ivec_t natural_stride_for(ivec_t extent)
+    {
+        for (auto d = 0; d < D; ++d)
+            extent[d] = extent[d] > 0 ? extent[d] : 1;
+        return detail::natural_stride_for(sizeof(T), extent);
+    }
+
+    static uint64_t storage_size_for(ivec_t const& extent)
+    {
+        uint64_t s = 1;
+        for (auto d = 0; d < D; ++d)
+            s *= uint64_t(extent[d]);
+        return s;
+    }
+};
+
+/// the stride type of power-of-two views, stores the log2 of the stride (in pixels) per dimension
+/// NOTE: only positive power-of-two multiples of the pixel size are representable (e.g. no mirrored views)
+template <class StorageViewT>
+struct pow2_stride
+{
+    static constexpr int dimensions = StorageViewT::dimensions;
+    static constexpr int pixel_size = int(sizeof(typename StorageViewT::pixel_t));
+    using ivec_t = tg::vec<dimensions, int>;
+
+    ivec_t shifts;
+
+    pow2_stride() = default;
+    pow2_stride(ivec_t const& byte_stride)
+    {
+        for (auto d = 0; d < dimensions; ++d)
+        {
+            auto const s = byte_stride[d] / pixel_size;
+            CC_ASSERT(s > 0 && s * pixel_size == byte_stride[d] && (s & (s - 1)) == 0 && "stride must be a power-of-two multiple of the pixel size");
+            shifts[d] = detail::ceil_log2(uint32_t(s));
+        }
+    }
+
+    operator ivec_t() const
+    {
+        ivec_t s;
+        for (auto d = 0; d < dimensions; ++d)
+            s[d] = pixel_size << shifts[d];
+        return s;
+    }
+    int operator[](int i) const { return pixel_size << shifts[i]; }
+};
+
+/// the stride type of images with a runtime channel count
+/// byte strides per dimension plus the number of channels per pixel (which is thus part of the view state)
+template <int D>
+struct channel_stride
+{
+    tg::vec<D, int> bytes;
+    int channels = 0;
+
+    operator tg::vec<D, int>() const { return bytes; }
+    int& operator[](int i) { return bytes[i]; }
+    int operator[](int i) const { return bytes[i]; }
 };
+
+/// strided linear storage of pixels with a runtime channel count (interleaved channels of type T)
+/// pixels are accessed as cc::span<T> with one element per channel
+/// NOTE: natural stride and storage size depend on the channel count (storage size is in channels, not pixels)
+template <class T, int D>
+struct channel_storage_view
+{
+    static constexpr bool is_strided_linear = false; // pixels are not of a single type
+    static constexpr int dimensions = D;
+
+    using pixel_t = T;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = cc::span<T>;
+    using ivec_t = tg::vec<D, int>;
+    using ipos_t = tg::pos<D, int>;
+    using stride_t = channel_stride<D>;
+
+    static pixel_access_t pixel_at(data_ptr_t data, ipos_t const& p, stride_t const& stride)
+    {
+        return {reinterpret_cast<T*>(data + detail::strided_offset(p, stride.bytes)), size_t(stride.channels)};
+    }
+
+    static int64_t byte_offset(ipos_t const& p, stride_t const& stride) { return detail::strided_offset(p, stride.bytes); }
+
+    static ivec_t natural_stride_for(ivec_t const& extent, int channels) { return detail::natural_stride_for(int(sizeof(T)) * channels, extent); }
+
+    static uint64_t storage_size_for(ivec_t const& extent, int channels)
+    {
+        uint64_t s = uint64_t(channels);
+        for (auto d = 0; d < D; ++d)
+            s *= uint64_t(extent[d]);
+        return s;
+    }
+};
+
+/// stride of planar images: byte strides inside a plane (shared by all planes) and the distance between planes
+template <int D>
+struct planar_stride
+{
+    tg::vec<D, int> bytes;
+    int64_t plane_bytes = 0;
+
+    operator tg::vec<D, int>() const { return bytes; }
+    int& operator[](int i) { return bytes[i]; }
+    int operator[](int i) const { return bytes[i]; }
+
+    bool operator==(planar_stride const& rhs) const { return bytes == rhs.bytes && plane_bytes == rhs.plane_bytes; }
+    bool operator!=(planar_stride const& rhs) const { return !operator==(rhs); }
+};
+
+/// proxy for a pixel of a planar image (one scalar per plane)
+/// converts to and can be assigned from PixelT, single channels are accessible via operator[]
+template <class PixelT, class ScalarT>
+struct planar_pixel_ref
+{
+    static constexpr int channels = pixel_traits<PixelT>::channels;
+    using byte_ptr_t = std::conditional_t<std::is_const_v<ScalarT>, std::byte const*, std::byte*>;
+
+    ScalarT* first;
+    int64_t plane_bytes;
+
+    ScalarT& operator[](int c) const { return *reinterpret_cast<ScalarT*>(reinterpret_cast<byte_ptr_t>(first) + c * plane_bytes); }
+
+    operator PixelT() const
+    {
+        PixelT p;
+        for (auto c = 0; c < channels; ++c)
+            p[c] = (*this)[c];
+        return p;
+    }
+    planar_pixel_ref const& operator=(PixelT const& p) const
+    {
+        for (auto c = 0; c < channels; ++c)
+            (*this)[c] = p[c];
+        return *this;
+    }
+    planar_pixel_ref const& operator=(planar_pixel_ref const& rhs) const { return *this = PixelT(rhs); }
+};
+
+/// planar storage: each channel is a separate plane of scalars, all planes share the same strides
+/// pixels are accessed via planar_pixel_ref (or by value for read-only images)
+/// NOTE: storage size is in pixels, see planar_storage
+template <class T, int D>
+struct planar_storage_view
+{
+    static constexpr bool is_strided_linear = false; // pixels are scattered over the planes
+    static constexpr int dimensions = D;
+    static constexpr int channels = pixel_traits<std::remove_const_t<T>>::channels;
+
+    using pixel_t = T;
+    using scalar_t = std::conditional_t<std::is_const_v<T>, typename pixel_traits<std::remove_const_t<T>>::scalar_t const,
+                                        typename pixel_traits<std::remove_const_t<T>>::scalar_t>;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = std::conditional_t<std::is_const_v<T>, std::remove_const_t<T>, planar_pixel_ref<T, scalar_t>>;
+    using ivec_t = tg::vec<D, int>;
+    using ipos_t = tg::pos<D, int>;
+    using stride_t = planar_stride<D>;
+
+    static_assert(sizeof(T) == channels * sizeof(scalar_t), "planar pixels must consist of tightly packed channels");
+
+    static pixel_access_t pixel_at(data_ptr_t data, ipos_t const& p, stride_t const& stride)
+    {
+        planar_pixel_ref<std::remove_const_t<T>, scalar_t> ref = {reinterpret_cast<scalar_t*>(data + detail::strided_offset(p, stride.bytes)), stride.plane_bytes};
+        return ref;
+    }
+
+    static int64_t byte_offset(ipos_t const& p, stride_t const& stride) { return detail::strided_offset(p, stride.bytes); }
+
+    /// planes of a compact image are stored back to back
+    static stride_t natural_stride_for(ivec_t const& extent)
+    {
+        int64_t plane = sizeof(scalar_t);
+        for (auto d = 0; d < D; ++d)
+            plane *= extent[d];
+        return {detail::natural_stride_for(int(sizeof(scalar_t)), extent), plane};
+    }
+
+    /// stride for the given (plane-internal) byte strides if the planes directly follow each other
+    static stride_t consecutive_planes_stride(ivec_t const& byte_stride, ivec_t const& extent)
+    {
+        int64_t plane = sizeof(scalar_t);
+        for (auto d = 0; d < D; ++d)
+        {
+            auto const s = int64_t(byte_stride[d] < 0 ? -byte_stride[d] : byte_stride[d]) * extent[d];
+            plane = s > plane ? s : plane;
+        }
+        return {byte_stride, plane};
+    }
+
+    static uint64_t storage_size_for(ivec_t const& extent)
+    {
+        uint64_t s = 1;
+        for (auto d = 0; d < D; ++d)
+            s *= uint64_t(extent[d]);
+        return s;
+    }
+};
+
+/// state of procedural views: the getter (ipos_t) -> PixelT, the optional setter (ipos_t, PixelT const&) -> void
+/// and the origin of subviews (functors always receive positions relative to the original view)
+template <int D, class GetterF, class SetterF>
+struct procedural_state
+{
+    detail::functor_storage<GetterF> get;
+    detail::functor_storage<SetterF> set;
+    tg::pos<D, int> origin;
+
+    procedural_state() = default;
+    procedural_state(GetterF g, SetterF s) : get(cc::move(g)), set(cc::move(s)) {}
+
+    /// procedural views have no memory, positions are enumerated row-major
+    operator tg::vec<D, int>() const { return tg::vec<D, int>(1); }
+};
+
+/// proxy for a pixel of a writeable procedural view
+/// NOTE: refers to the state of the view (or iterator) it was obtained from
+template <class PixelT, class StateT, int D>
+struct procedural_pixel_ref
+{
+    StateT const* state;
+    tg::pos<D, int> pos;
+
+    operator PixelT() const { return state->get(pos); }
+    procedural_pixel_ref const& operator=(PixelT const& v) const
+    {
+        state->set(pos, v);
+        return *this;
+    }
+    procedural_pixel_ref const& operator=(procedural_pixel_ref const& rhs) const { return *this = PixelT(rhs); }
+};
+
+/// storage view of procedural views: pixels are computed by the getter on each access (and written by the setter)
+template <class T, int D, class GetterF, class SetterF>
+struct procedural_storage_view
+{
+    static constexpr bool is_strided_linear = false;
+
+    using pixel_t = T;
+    using value_t = std::remove_const_t<T>;
+    using data_ptr_t = std::byte const*; // unused, procedural views have no memory
+    using stride_t = procedural_state<D, GetterF, SetterF>;
+    using pixel_access_t = std::conditional_t<std::is_const_v<T>, value_t, procedural_pixel_ref<value_t, stride_t, D>>;
+    using ipos_t = tg::pos<D, int>;
+
+    static value_t value_at(ipos_t const& p, stride_t const& state) { return state.get(state.origin + tg::vec<D, int>(p)); }
+
+    static pixel_access_t pixel_at(data_ptr_t, ipos_t const& p, stride_t const& state)
+    {
+        if constexpr (std::is_const_v<T>)
+            return value_at(p, state);
+        else
+            return {&state, state.origin + tg::vec<D, int>(p)};
+    }
+
+    static int64_t byte_offset(ipos_t const&, stride_t const&) { return 0; } // subviews move the origin instead
+};
+
+/// row-major blocks, each pixel is decoded on access (i.e. read-only and returned by value)
+/// NOTE: the stride is in blocks, i.e. (block size in bytes, bytes per block row)
+/// NOTE: positions relative to the data ptr must be block-aligned, thus subviews have to start at block boundaries
 template <class T, class BlockT>
 struct linear_block_storage_view
 {
     static constexpr bool is_strided_linear = false;
+    static constexpr int block_width = BlockT::block_sizes[0];
+    static constexpr int block_height = BlockT::block_sizes[1];
+
+    using pixel_t = T;
+    using block_t = BlockT;
+    using data_ptr_t = std::byte const*;
+    using pixel_access_t = std::remove_const_t<T>;
+
+    static block_t const& block_at(data_ptr_t data, tg::ipos2 p, tg::ivec2 stride)
+    {
+        return *reinterpret_cast<block_t const*>(data + byte_offset(p, stride));
+    }
+
+    static pixel_access_t pixel_at(data_ptr_t data, tg::ipos2 p, tg::ivec2 stride)
+    {
+        auto const c = block_at(data, p, stride).decode_pixel(p.x % block_width, p.y % block_height);
+        if constexpr (std::is_same_v<pixel_access_t, tg::color4>)
+            return c;
+        else
+        {
+            pixel_access_t r;
+            default_converter{}(r, c);
+            return r;
+        }
+    }
+
+    static int64_t byte_offset(tg::ipos2 p, tg::ivec2 stride) { return int64_t(p.x / block_width) * stride.x + int64_t(p.y / block_height) * stride.y; }
+
+    static tg::ivec2 natural_stride_for(tg::ivec2 extent)
+    {
+        return {int(sizeof(block_t)), (extent.x + block_width - 1) / block_width * int(sizeof(block_t))};
+    }
+
+    static uint64_t storage_size_for(tg::ivec2 extent)
+    {
+        return uint64_t((extent.x + block_width - 1) / block_width) * uint64_t((extent.y + block_height - 1) / block_height);
+    }
 };
+
+/// 2D Morton order (see detail/morton.hh for the exact layout)
+/// NOTE: the stride is (pixel size in bytes, number of interleaved bits per coordinate)
 template <class T>
 struct z_storage_view
 {
     static constexpr bool is_strided_linear = false;
+
+    using pixel_t = T;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = T&;
+
+    static pixel_access_t pixel_at(data_ptr_t data, tg::ipos2 p, tg::ivec2 stride) { return *reinterpret_cast<T*>(data + byte_offset(p, stride)); }
+
+    static int64_t byte_offset(tg::ipos2 p, tg::ivec2 stride) { return int64_t(detail::morton_index(p.x, p.y, stride.y)) * stride.x; }
+
+    static tg::ivec2 natural_stride_for(tg::ivec2 extent) { return {int(sizeof(T)), detail::morton_interleaved_bits(extent.x, extent.y)}; }
+
+    static uint64_t storage_size_for(tg::ivec2 extent) { return detail::morton_storage_size(extent.x, extent.y); }
+};
+
+/// fixed-size tiles (bricks) in row-major tile order, pixels inside a tile are row-major
+/// tile sizes are compile-time powers of two, partial tiles at the border are padded
+/// NOTE: the stride is in tiles, i.e. (bytes per tile, bytes per tile row[, bytes per tile slice])
+/// NOTE: positions relative to the data ptr must be tile-aligned, thus subviews have to start at tile boundaries
+template <class T, int TileW, int TileH, int TileD>
+struct tiled_storage_view
+{
+    static_assert(TileW > 0 && (TileW & (TileW - 1)) == 0, "tile sizes must be powers of two");
+    static_assert(TileH > 0 && (TileH & (TileH - 1)) == 0, "tile sizes must be powers of two");
+    static_assert(TileD > 0 && (TileD & (TileD - 1)) == 0, "tile sizes must be powers of two");
+
+    static constexpr bool is_strided_linear = false;
+    static constexpr int tile_sizes[3] = {TileW, TileH, TileD};
+    static constexpr int tile_shifts[3] = {detail::ceil_log2(TileW), detail::ceil_log2(TileH), detail::ceil_log2(TileD)};
+    static constexpr int max_tile_size = TileW > TileH ? (TileW > TileD ? TileW : TileD) : (TileH > TileD ? TileH : TileD);
+
+    using pixel_t = T;
+    using data_ptr_t = std::conditional_t<std::is_const_v<T>, std::byte const*, std::byte*>;
+    using pixel_access_t = T&;
+
+    template <int D>
+    static pixel_access_t pixel_at(data_ptr_t data, tg::pos<D, int> p, tg::vec<D, int> stride)
+    {
+        return *reinterpret_cast<T*>(data + byte_offset(p, stride));
+    }
+
+    template <int D>
+    static int64_t byte_offset(tg::pos<D, int> p, tg::vec<D, int> stride)
+    {
+        static_assert(D == 2 || D == 3, "only 2D and 3D images can be tiled");
+        int64_t offset = 0;
+        int64_t local = 0;
+        for (auto d = D - 1; d >= 0; --d)
+        {
+            offset += int64_t(p[d] >> tile_shifts[d]) * stride[d];
+            local = (local << tile_shifts[d]) + (p[d] & (tile_sizes[d] - 1));
+        }
+        return offset + local * int64_t(sizeof(T));
+    }
+
+    template <int D>
+    static tg::vec<D, int> natural_stride_for(tg::vec<D, int> extent)
+    {
+        tg::vec<D, int> stride;
+        auto s = int(sizeof(T));
+        for (auto d = 0; d < D; ++d)
+            s *= tile_sizes[d];
+        for (auto d = 0; d < D; ++d)
+        {
+            stride[d] = s;
+            s *= (extent[d] + tile_sizes[d] - 1) >> tile_shifts[d];
+        }
+        return stride;
+    }
+
+    template <int D>
+    static uint64_t storage_size_for(tg::vec<D, int> extent)
+    {
+        uint64_t s = 1;
+        for (auto d = 0; d < D; ++d)
+            s *= uint64_t((extent[d] + tile_sizes[d] - 1) >> tile_shifts[d]) << tile_shifts[d];
+        return s;
+    }
 };
 }
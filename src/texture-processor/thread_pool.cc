@@ -0,0 +1,236 @@
+#include "thread_pool.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <clean-core/assert.hh>
+#include <clean-core/move.hh>
+
+namespace
+{
+// pool currently executing a task on this thread (used to detect nested parallel_for)
+thread_local tp::thread_pool const* t_current_pool = nullptr;
+
+// range of indices owned by a single thread
+// the owner pops from the front, thieves take the back half
+struct work_range
+{
+    std::mutex mutex;
+    int64_t begin = 0;
+    int64_t end = 0;
+};
+}
+
+struct tp::thread_pool::impl
+{
+    std::vector<std::thread> workers;
+    std::vector<work_range> ranges; // one per thread, [0] is the calling thread
+
+    std::mutex submit_mutex; // serializes concurrent parallel_for calls
+
+    std::mutex mutex;
+    std::condition_variable cv_start;
+    std::condition_variable cv_done;
+    uint64_t generation = 0;
+    int active_workers = 0;
+    bool stop = false;
+
+    cc::function_ref<void(int64_t)>* job = nullptr;
+
+    // the first exception thrown by the job (guarded by mutex), remaining indices are skipped after it
+    std::exception_ptr error;
+    std::atomic<bool> cancelled = false;
+
+    explicit impl(int num_threads) : ranges(num_threads) {}
+
+    bool pop(int slot, int64_t& idx)
+    {
+        auto& r = ranges[slot];
+        std::lock_guard lock(r.mutex);
+        if (r.begin == r.end)
+            return false;
+        idx = r.begin++;
+        return true;
+    }
+
+    bool steal(int slot)
+    {
+        auto const n = int(ranges.size());
+        for (auto o = 1; o < n; ++o)
+        {
+            auto& victim = ranges[(slot + o) % n];
+            int64_t begin, end;
+            {
+                std::lock_guard lock(victim.mutex);
+                auto const remaining = victim.end - victim.begin;
+                if (remaining <= 0)
+                    continue;
+
+                end = victim.end;
+                begin = victim.end - (remaining + 1) / 2;
+                victim.end = begin;
+            }
+
+            auto& own = ranges[slot];
+            std::lock_guard lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+            return true;
+        }
+        return false;
+    }
+
+    void participate(thread_pool const* pool, int slot)
+    {
+        auto const prev_pool = t_current_pool;
+        t_current_pool = pool;
+
+        auto& f = *job;
+        int64_t idx;
+        while (!cancelled.load(std::memory_order_relaxed))
+        {
+            if (pop(slot, idx))
+            {
+                try
+                {
+                    f(idx);
+                }
+                catch (...)
+                {
+                    cancel(std::current_exception());
+                }
+            }
+            else if (!steal(slot))
+                break;
+        }
+
+        t_current_pool = prev_pool;
+    }
+
+    // records the first exception and drops all remaining work
+    void cancel(std::exception_ptr e)
+    {
+        {
+            std::lock_guard lock(mutex);
+            if (!error)
+                error = cc::move(e);
+        }
+        cancelled.store(true, std::memory_order_relaxed);
+        for (auto& r : ranges)
+        {
+            std::lock_guard lock(r.mutex);
+            r.begin = r.end;
+        }
+    }
+
+    void worker_main(thread_pool const* pool, int slot)
+    {
+        uint64_t seen_generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(mutex);
+                cv_start.wait(lock, [&] { return stop || generation != seen_generation; });
+                if (stop)
+                    return;
+                seen_generation = generation;
+            }
+
+            participate(pool, slot);
+
+            {
+                std::lock_guard lock(mutex);
+                if (--active_workers == 0)
+                    cv_done.notify_one();
+            }
+        }
+    }
+};
+
+tp::thread_pool::thread_pool(int num_threads)
+{
+    if (num_threads <= 0)
+        num_threads = int(std::thread::hardware_concurrency());
+    if (num_threads <= 0)
+        num_threads = 1;
+
+    _impl = new impl(num_threads);
+    _impl->workers.reserve(num_threads - 1);
+    for (auto i = 1; i < num_threads; ++i)
+        _impl->workers.emplace_back([this, i] { _impl->worker_main(this, i); });
+}
+
+tp::thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard lock(_impl->mutex);
+        _impl->stop = true;
+    }
+    _impl->cv_start.notify_all();
+    for (auto& t : _impl->workers)
+        t.join();
+    delete _impl;
+}
+
+tp::thread_pool& tp::thread_pool::global()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+int tp::thread_pool::num_threads() const { return int(_impl->ranges.size()); }
+
+void tp::thread_pool::parallel_for(int64_t count, cc::function_ref<void(int64_t)> f)
+{
+    if (count <= 0)
+        return;
+
+    // sequential fallback: trivial work, no workers, or nested call
+    if (count == 1 || _impl->workers.empty() || t_current_pool == this)
+    {
+        for (int64_t i = 0; i < count; ++i)
+            f(i);
+        return;
+    }
+
+    std::lock_guard submit_lock(_impl->submit_mutex);
+
+    // distribute range evenly
+    auto const n = int64_t(_impl->ranges.size());
+    for (int64_t i = 0; i < n; ++i)
+    {
+        auto& r = _impl->ranges[i];
+        std::lock_guard lock(r.mutex);
+        r.begin = count * i / n;
+        r.end = count * (i + 1) / n;
+    }
+
+    {
+        std::lock_guard lock(_impl->mutex);
+        _impl->job = &f;
+        _impl->error = nullptr;
+        _impl->cancelled.store(false, std::memory_order_relaxed);
+        _impl->active_workers = int(_impl->workers.size());
+        ++_impl->generation;
+    }
+    _impl->cv_start.notify_all();
+
+    _impl->participate(this, 0);
+
+    // wait until all workers are done touching the job (also if it threw)
+    std::exception_ptr error;
+    {
+        std::unique_lock lock(_impl->mutex);
+        _impl->cv_done.wait(lock, [&] { return _impl->active_workers == 0; });
+        _impl->job = nullptr;
+        error = cc::move(_impl->error);
+        _impl->error = nullptr;
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+#include <clean-core/function_ref.hh>
+
+namespace tp
+{
+/**
+ * A small work-stealing thread pool for data-parallel loops (e.g. tile-parallel image processing)
+ *
+ * parallel_for distributes the index range evenly over all threads (including the calling one)
+ * threads that run out of work steal half of the remaining range of another thread
+ *
+ * NOTE: parallel_for blocks until all indices have been processed
+ *       nested calls from within a pool thread are executed sequentially
+ *       concurrent calls from different threads are serialized
+ */
+struct thread_pool
+{
+    // ctors
+public:
+    /// creates a pool with the given number of threads (including the calling thread)
+    /// num_threads <= 0 means one thread per hardware thread
+    explicit thread_pool(int num_threads = 0);
+    ~thread_pool();
+
+    thread_pool(thread_pool&&) = delete;
+    thread_pool(thread_pool const&) = delete;
+    thread_pool& operator=(thread_pool&&) = delete;
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    /// the default pool used by tp::par
+    /// (lazily created with one thread per hardware thread)
+    static thread_pool& global();
+
+    // api
+public:
+    /// number of threads that participate in parallel_for (including the calling thread)
+    int num_threads() const;
+
+    /// calls f(i) for each i in [0, count)
+    /// the order and thread assignment of calls is unspecified
+    /// if f throws, the remaining indices are skipped and the first exception is rethrown on the calling thread
+    /// (after all threads have stopped calling f)
+    void parallel_for(int64_t count, cc::function_ref<void(int64_t)> f);
+
+private:
+    struct impl;
+    impl* _impl = nullptr;
+};
+}
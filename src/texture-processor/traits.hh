@@ -3,9 +3,13 @@
 #include <cstdint>
 #include <type_traits>
 
+#include <clean-core/span.hh>
+
 #include <typed-geometry/tg-lean.hh>
 
+#include <texture-processor/detail/functor.hh>
 #include <texture-processor/detail/slicing.hh>
+#include <texture-processor/extents.hh>
 #include <texture-processor/fwd.hh>
 #include <texture-processor/image_metadata.hh>
 #include <texture-processor/pixel_traits.hh>
@@ -14,30 +18,58 @@ namespace tp
 {
 namespace base_traits
 {
-template <class PixelT>
-struct linear2D
+/// common base of all strided linear images (interleaved pixels, arbitrary stride per dimension)
+template <class PixelT, class ExtentT, int D, tp::image_type ImageType>
+struct strided_linear
 {
     static_assert(!std::is_reference_v<PixelT>, "cannot store references");
 
     using pixel_t = PixelT;
     using pixel_traits = tp::pixel_traits<std::decay_t<PixelT>>;
-    using extent_t = extent2;
+    using extent_t = ExtentT;
     using storage_t = linear_storage<pixel_t>;
     using storage_view_t = linear_storage_view<pixel_t>;
     using pixel_access_t = pixel_t&;
 
-    static constexpr int dimensions = 2;
+    static constexpr int dimensions = D;
     static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
     static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = false;
     static constexpr bool is_strided_linear = true;
-    static constexpr tp::image_type image_type = tp::image_type::image2D;
+    static constexpr tp::image_type image_type = ImageType;
     static constexpr tp::layout_type layout_type = tp::layout_type::strided_linear;
 
     using position_iterator_t = detail::strided_linear_pos_iterator<dimensions>;
+    using row_iterator_t = detail::strided_linear_row_iterator<dimensions, storage_view_t>;
     using pixel_iterator_t = detail::strided_linear_pixel_iterator<dimensions, storage_view_t>;
     using entry_iterator_t = detail::strided_linear_entry_iterator<dimensions, storage_view_t>;
 };
 
+template <class PixelT>
+struct linear1D : strided_linear<PixelT, extent1, 1, tp::image_type::image1D>
+{
+};
+template <class PixelT>
+struct linear2D : strided_linear<PixelT, extent2, 2, tp::image_type::image2D>
+{
+};
+template <class PixelT>
+struct linear3D : strided_linear<PixelT, extent3, 3, tp::image_type::image3D>
+{
+};
+template <class PixelT>
+struct linear1D_array : strided_linear<PixelT, extent1_array, 2, tp::image_type::image1DArray>
+{
+};
+template <class PixelT>
+struct linear2D_array : strided_linear<PixelT, extent2_array, 3, tp::image_type::image2DArray>
+{
+};
+template <class PixelT>
+struct linear_cube : strided_linear<PixelT, extent_cube, 3, tp::image_type::imageCube>
+{
+};
+
 template <class PixelT>
 struct z2D
 {
@@ -53,40 +85,347 @@ struct z2D
     static constexpr int dimensions = 2;
     static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
     static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = false;
     static constexpr bool is_strided_linear = false;
     static constexpr tp::image_type image_type = tp::image_type::image2D;
     static constexpr tp::layout_type layout_type = tp::layout_type::z_order;
 
-    using position_iterator_t = void; // TODO
+    using position_iterator_t = detail::z_order_pos_iterator;
+    using row_iterator_t = void; // no rows in Z-order
+    using pixel_iterator_t = detail::z_order_pixel_iterator<storage_view_t>;
+    using entry_iterator_t = detail::z_order_entry_iterator<storage_view_t>;
+};
+
+/// strided linear image with a compile-time extent (see fixed_extentN)
+/// views carry only the data ptr, strides are always natural (derived at compile time)
+/// subviews are regular strided linear views of DynamicT
+template <class PixelT, class ExtentT, class DynamicT>
+struct fixed_linear : DynamicT
+{
+    static_assert(is_fixed_extent<ExtentT>, "fixed images require a fixed extent");
+
+    using extent_t = ExtentT;
+    using storage_view_t = fixed_linear_storage_view<PixelT, ExtentT>;
+    using stride_t = fixed_stride<storage_view_t>;
+    using subview_base_t = DynamicT;
+
+    using row_iterator_t = detail::strided_linear_row_iterator<DynamicT::dimensions, storage_view_t>;
+    using pixel_iterator_t = detail::strided_linear_pixel_iterator<DynamicT::dimensions, storage_view_t>;
+    using entry_iterator_t = detail::strided_linear_entry_iterator<DynamicT::dimensions, storage_view_t>;
+};
+
+template <class PixelT, int W>
+struct fixed1D : fixed_linear<PixelT, fixed_extent1<W>, linear1D<PixelT>>
+{
+};
+template <class PixelT, int W, int H>
+struct fixed2D : fixed_linear<PixelT, fixed_extent2<W, H>, linear2D<PixelT>>
+{
+};
+template <class PixelT, int W, int H, int D>
+struct fixed3D : fixed_linear<PixelT, fixed_extent3<W, H, D>, linear3D<PixelT>>
+{
+};
+
+/// strided linear image with power-of-two extents (see pow2_extentN)
+/// pixels are addressed with shifts (strides are power-of-two multiples of the pixel size)
+/// and repeated lookups are bit masks (see lookup::repeated)
+/// subviews are regular strided linear views of DynamicT
+template <class PixelT, class ExtentT, class DynamicT>
+struct pow2_linear : DynamicT
+{
+    static_assert(is_pow2_extent<ExtentT>, "power-of-two images require a power-of-two extent");
+
+    using extent_t = ExtentT;
+    using storage_view_t = pow2_linear_storage_view<PixelT, DynamicT::dimensions>;
+    using stride_t = pow2_stride<storage_view_t>;
+    using subview_base_t = DynamicT;
+
+    using row_iterator_t = detail::strided_linear_row_iterator<DynamicT::dimensions, storage_view_t>;
+    using pixel_iterator_t = detail::strided_linear_pixel_iterator<DynamicT::dimensions, storage_view_t>;
+    using entry_iterator_t = detail::strided_linear_entry_iterator<DynamicT::dimensions, storage_view_t>;
+};
+
+template <class PixelT>
+struct pow2_1D : pow2_linear<PixelT, pow2_extent1, linear1D<PixelT>>
+{
+};
+template <class PixelT>
+struct pow2_2D : pow2_linear<PixelT, pow2_extent2, linear2D<PixelT>>
+{
+};
+template <class PixelT>
+struct pow2_3D : pow2_linear<PixelT, pow2_extent3, linear3D<PixelT>>
+{
+};
+
+/// common base of all tiled images (fixed-size tiles of row-major pixels, see tiled_storage_view)
+template <class PixelT, class ExtentT, int D, tp::image_type ImageType, int TileW, int TileH, int TileD>
+struct tiled
+{
+    static_assert(!std::is_reference_v<PixelT>, "cannot store references");
+
+    using pixel_t = PixelT;
+    using pixel_traits = tp::pixel_traits<std::decay_t<PixelT>>;
+    using extent_t = ExtentT;
+    using storage_t = tiled_storage<pixel_t>;
+    using storage_view_t = tiled_storage_view<pixel_t, TileW, TileH, TileD>;
+    using pixel_access_t = pixel_t&;
+
+    static constexpr int dimensions = D;
+    static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
+    static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = false;
+    static constexpr bool is_strided_linear = false;
+    static constexpr tp::image_type image_type = ImageType;
+    static constexpr tp::layout_type layout_type = tp::layout_type::tiled;
+
+    using position_iterator_t = detail::tiled_pos_iterator<dimensions, storage_view_t>;
+    using row_iterator_t = detail::tiled_row_iterator<dimensions, storage_view_t>;
+    using pixel_iterator_t = detail::tiled_pixel_iterator<dimensions, storage_view_t>;
+    using entry_iterator_t = detail::tiled_entry_iterator<dimensions, storage_view_t>;
+};
+
+template <class PixelT, int TileW, int TileH>
+struct tiled2D : tiled<PixelT, extent2, 2, tp::image_type::image2D, TileW, TileH, 1>
+{
+};
+template <class PixelT, int TileW, int TileH, int TileD>
+struct tiled3D : tiled<PixelT, extent3, 3, tp::image_type::image3D, TileW, TileH, TileD>
+{
+};
+
+/// image with a runtime channel count (e.g. material layers or spectral data)
+/// pixels are interleaved channels of ScalarT and accessed as cc::span<ScalarT> (one element per channel)
+/// the channel count is part of the view (see image_view::channel_count()), so one instantiation serves all counts
+template <class ScalarT, class ExtentT, int D, tp::image_type ImageType>
+struct dynamic_channels
+{
+    static_assert(!std::is_reference_v<ScalarT>, "cannot store references");
+
+    using pixel_t = ScalarT;
+    using pixel_traits = tp::pixel_traits<std::decay_t<ScalarT>>;
+    using extent_t = ExtentT;
+    using storage_t = linear_storage<pixel_t>;
+    using storage_view_t = channel_storage_view<pixel_t, D>;
+    using stride_t = channel_stride<D>;
+    using pixel_access_t = cc::span<pixel_t>;
+
+    static constexpr int dimensions = D;
+    static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
+    static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = true;
+    static constexpr bool is_strided_linear = false;
+    static constexpr tp::image_type image_type = ImageType;
+    static constexpr tp::layout_type layout_type = tp::layout_type::strided_linear;
+
+    using position_iterator_t = detail::strided_linear_pos_iterator<dimensions>;
+    using row_iterator_t = void; // pixels are spans, see detail::copy_channel_run for bulk kernels
+    using pixel_iterator_t = detail::addressed_pixel_iterator<dimensions, storage_view_t>;
+    using entry_iterator_t = detail::addressed_entry_iterator<dimensions, storage_view_t>;
+};
+
+template <class ScalarT>
+struct channels1D : dynamic_channels<ScalarT, extent1, 1, tp::image_type::image1D>
+{
+};
+template <class ScalarT>
+struct channels2D : dynamic_channels<ScalarT, extent2, 2, tp::image_type::image2D>
+{
+};
+template <class ScalarT>
+struct channels3D : dynamic_channels<ScalarT, extent3, 3, tp::image_type::image3D>
+{
+};
+
+/// planar (SoA) image: each channel of PixelT is stored in its own plane of scalars
+/// pixels are accessed via a proxy (planar_pixel_ref) that reads and writes all planes
+/// single planes are regular scalar images of LinearT (see image_view::channel(c)) and are the preferred way for per-channel kernels
+template <class PixelT, class ExtentT, int D, tp::image_type ImageType, template <class> class LinearT>
+struct planar
+{
+    static_assert(!std::is_reference_v<PixelT>, "cannot store references");
+
+    using pixel_t = PixelT;
+    using pixel_traits = tp::pixel_traits<std::decay_t<PixelT>>;
+    using plane_base_t = LinearT<std::conditional_t<std::is_const_v<PixelT>, typename pixel_traits::scalar_t const, typename pixel_traits::scalar_t>>;
+    using extent_t = ExtentT;
+    using storage_t = planar_storage<pixel_t>;
+    using storage_view_t = planar_storage_view<pixel_t, D>;
+    using stride_t = planar_stride<D>;
+    using pixel_access_t = typename storage_view_t::pixel_access_t;
+
+    static constexpr int dimensions = D;
+    static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
+    static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = false;
+    static constexpr bool is_strided_linear = false;
+    static constexpr tp::image_type image_type = ImageType;
+    static constexpr tp::layout_type layout_type = tp::layout_type::planar;
+
+    using position_iterator_t = detail::strided_linear_pos_iterator<dimensions>;
+    using row_iterator_t = void; // pixels are proxies, see detail/planar.hh for bulk kernels
+    using pixel_iterator_t = detail::addressed_pixel_iterator<dimensions, storage_view_t>;
+    using entry_iterator_t = detail::addressed_entry_iterator<dimensions, storage_view_t>;
+};
+
+template <class PixelT>
+struct planar2D : planar<PixelT, extent2, 2, tp::image_type::image2D, linear2D>
+{
+};
+template <class PixelT>
+struct planar3D : planar<PixelT, extent3, 3, tp::image_type::image3D, linear3D>
+{
+};
+
+/// lazily computed (procedural or mapped) image without memory, see procedural.hh
+/// pixels are computed by GetterF (ipos_t) -> PixelT on access, writes go to SetterF (ipos_t, PixelT const&) if it is not detail::no_setter
+/// MaterializedT are the base traits of images that store such pixels (e.g. linear2D<PixelT>) and defines extent and dimensions
+template <class PixelT, class MaterializedT, class GetterF, class SetterF>
+struct procedural
+{
+    static_assert(!std::is_reference_v<PixelT>, "cannot store references");
+
+    static constexpr bool is_writeable = !std::is_same_v<SetterF, detail::no_setter>;
+    static constexpr int dimensions = MaterializedT::dimensions;
+
+    using pixel_t = std::conditional_t<is_writeable, PixelT, PixelT const>;
+    using pixel_traits = tp::pixel_traits<std::decay_t<PixelT>>;
+    using extent_t = typename MaterializedT::extent_t;
+    using storage_t = void; // no memory
+    using storage_view_t = procedural_storage_view<pixel_t, dimensions, GetterF, SetterF>;
+    using stride_t = procedural_state<dimensions, GetterF, SetterF>;
+    using pixel_access_t = typename storage_view_t::pixel_access_t;
+    using image_base_t = MaterializedT;
+
+    static constexpr bool is_block_based = false;
+    static constexpr bool has_dynamic_channels = false;
+    static constexpr bool is_strided_linear = false;
+    static constexpr tp::image_type image_type = MaterializedT::image_type;
+    static constexpr tp::layout_type layout_type = tp::layout_type::procedural;
+
+    using position_iterator_t = detail::strided_linear_pos_iterator<dimensions>;
+    using row_iterator_t = void; // no memory
+    using pixel_iterator_t = detail::addressed_pixel_iterator<dimensions, storage_view_t>;
+    using entry_iterator_t = detail::addressed_entry_iterator<dimensions, storage_view_t>;
 };
 
+/// block-compressed 2D image, PixelT is the type that pixels are decoded to (usually tg::color4)
+/// NOTE: pixels are decoded on access and thus read-only
 template <class PixelT, class BlockT>
 struct block2D
 {
-    using pixel_t = PixelT;
+    using pixel_t = std::add_const_t<PixelT>;
     using pixel_traits = tp::pixel_traits<std::decay_t<PixelT>>;
     using block_t = BlockT;
     using extent_t = extent2;
     using storage_t = linear_block_storage<pixel_t, block_t>;
     using storage_view_t = linear_block_storage_view<pixel_t, block_t>;
-    using pixel_access_t = pixel_t;
+    using pixel_access_t = std::remove_const_t<pixel_t>;
 
     static constexpr int dimensions = 2;
-    static constexpr bool is_writeable = !std::is_const_v<pixel_t>;
+    static constexpr bool is_writeable = false;
     static constexpr bool is_block_based = true;
-    static constexpr bool is_strided_linear = true;
+    static constexpr bool has_dynamic_channels = false;
+    static constexpr bool is_strided_linear = false;
     static constexpr auto block_sizes = block_t::block_sizes;
     static constexpr tp::image_type image_type = tp::image_type::image2D;
     static constexpr tp::layout_type layout_type = tp::layout_type::strided_linear;
 
-    using position_iterator_t = void; // TODO
+    using position_iterator_t = detail::block_pos_iterator<storage_view_t>;
+    using row_iterator_t = void; // no rows in block images
+    using pixel_iterator_t = detail::block_pixel_iterator<storage_view_t>;
+    using entry_iterator_t = detail::block_entry_iterator<storage_view_t>;
 };
 }
 
 // TODO: "mapping views" (like treating an rgb image as a grayscale image via "map")
-// TODO: allow arrays as pixels for dynamic channel size
-// TODO: optimized power-of-two images?
-// TODO: tiled images (each axis independently, maybe only sampler property)
+
+namespace detail
+{
+template <class BaseT, class = void>
+struct stride_type_of
+{
+    using type = tg::vec<BaseT::dimensions, int>;
+};
+template <class BaseT>
+struct stride_type_of<BaseT, std::void_t<typename BaseT::stride_t>>
+{
+    using type = typename BaseT::stride_t;
+};
+/// rebinds single-parameter base traits (e.g. linear2D<PixelT>) to a new pixel type
+template <class BaseT, class NewPixelT>
+struct rebind_pixel
+{
+    using type = void;
+};
+template <template <class> class BaseTT, class PixelT, class NewPixelT>
+struct rebind_pixel<BaseTT<PixelT>, NewPixelT>
+{
+    using type = BaseTT<NewPixelT>;
+};
+
+/// rebinds base traits to read-only pixels, keeping tiling, compile-time extents and block types
+/// NOTE: unlike rebind_pixel, this also covers base traits with non-type parameters
+template <class BaseT>
+struct add_const_pixel
+{
+    using type = typename rebind_pixel<BaseT, typename BaseT::pixel_t const>::type;
+};
+template <class PixelT, int W>
+struct add_const_pixel<base_traits::fixed1D<PixelT, W>>
+{
+    using type = base_traits::fixed1D<PixelT const, W>;
+};
+template <class PixelT, int W, int H>
+struct add_const_pixel<base_traits::fixed2D<PixelT, W, H>>
+{
+    using type = base_traits::fixed2D<PixelT const, W, H>;
+};
+template <class PixelT, int W, int H, int D>
+struct add_const_pixel<base_traits::fixed3D<PixelT, W, H, D>>
+{
+    using type = base_traits::fixed3D<PixelT const, W, H, D>;
+};
+template <class PixelT, int TileW, int TileH>
+struct add_const_pixel<base_traits::tiled2D<PixelT, TileW, TileH>>
+{
+    using type = base_traits::tiled2D<PixelT const, TileW, TileH>;
+};
+template <class PixelT, int TileW, int TileH, int TileD>
+struct add_const_pixel<base_traits::tiled3D<PixelT, TileW, TileH, TileD>>
+{
+    using type = base_traits::tiled3D<PixelT const, TileW, TileH, TileD>;
+};
+template <class PixelT, class BlockT>
+struct add_const_pixel<base_traits::block2D<PixelT, BlockT>>
+{
+    using type = base_traits::block2D<PixelT, BlockT>; // already read-only
+};
+
+template <class BaseT, class = void>
+struct image_base_of
+{
+    using type = BaseT;
+};
+template <class BaseT>
+struct image_base_of<BaseT, std::void_t<typename BaseT::image_base_t>>
+{
+    using type = typename BaseT::image_base_t;
+};
+
+template <class BaseT, class = void>
+struct subview_base_of
+{
+    using type = BaseT;
+};
+template <class BaseT>
+struct subview_base_of<BaseT, std::void_t<typename BaseT::subview_base_t>>
+{
+    using type = typename BaseT::subview_base_t;
+};
+}
+
 template <class BaseT>
 struct traits : BaseT
 {
@@ -102,17 +441,30 @@ struct traits : BaseT
     using storage_t = typename base_t::storage_t;
     using storage_view_t = typename base_t::storage_view_t;
 
-    // TODO: dynamic channels
-    static constexpr int channels = pixel_traits::channels;
+    /// type of the byte stride member of views (empty for fixed-size views)
+    using stride_t = typename detail::stride_type_of<base_t>::type;
+    /// traits of subviews (fixed-size views have dynamically sized subviews)
+    using subview_base_t = typename detail::subview_base_of<base_t>::type;
+    static constexpr bool has_fixed_extent = is_fixed_extent<extent_t>;
+    static constexpr bool has_pow2_extent = is_pow2_extent<extent_t>;
+    /// false if the stride type restricts the representable strides (e.g. no mirroring or swapping)
+    static constexpr bool has_arbitrary_stride
+        = std::is_same_v<stride_t, ivec_t> || base_t::has_dynamic_channels || base_t::layout_type == tp::layout_type::planar;
+
+    /// 0 for a runtime channel count (see image_view::channel_count())
+    static constexpr int channels = base_t::has_dynamic_channels ? 0 : pixel_traits::channels;
 
     template <class NewExtentT>
     using change_extent_t = void; // TODO
+    /// same kind of image with a different pixel type (void if the base traits cannot be rebound)
+    /// NOTE: fixed-size and power-of-two traits are rebound to their dynamic (subview) traits
     template <class NewPixelT>
-    using change_pixel_t = void; // TODO
+    using change_pixel_t = typename detail::rebind_pixel<subview_base_t, NewPixelT>::type;
     template <class NewStorageT>
     using change_storage_t = void; // TODO
 
-    using const_traits = change_pixel_t<pixel_t const>;
+    /// same kind of image with read-only pixels (void for writeable procedural images)
+    using const_traits = typename detail::add_const_pixel<base_t>::type;
     template <int D>
     using sliced_traits = change_extent_t<detail::sliced_extents<extent_t, D>>;
     template <int D>
@@ -131,6 +483,15 @@ struct traits : BaseT
         md.layout = base_t::layout_type;
         md.pixel_space = pixel_traits::space;
         md.pixel_format = pixel_traits::format;
+        if constexpr (base_t::is_block_based)
+        {
+            md.pixel_format = base_t::block_t::format;
+            if (is_srgb_format(md.pixel_format))
+                md.pixel_space = pixel_space::sRGB;
+        }
+        if constexpr (base_t::layout_type == tp::layout_type::tiled)
+            for (auto d = 0; d < base_t::dimensions; ++d)
+                md.tile_extent[d] = storage_view_t::tile_sizes[d];
         return md;
     }
 };
@@ -164,8 +525,9 @@ static constexpr bool is_image_or_view = is_image<T> || is_image_view<T>;
 
 template <class ImageOrViewT>
 using pixel_type_of = typename ImageOrViewT::pixel_t;
+/// NOTE: for views without memory (e.g. procedural views), this is the image type that materializes them
 template <class ImageOrViewT>
-using image_type_of = image<typename ImageOrViewT::traits>;
+using image_type_of = image<typename detail::image_base_of<typename ImageOrViewT::traits::base_t>::type>;
 template <class ImageOrViewT>
-using image_view_type_of = image_view<typename ImageOrViewT::traits>;
+using image_view_type_of = image_view<typename ImageOrViewT::traits::base_t>;
 }